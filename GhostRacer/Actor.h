@@ -5,6 +5,40 @@
 
 class StudentWorld;
 
+//type tags for the concrete actor classes (save states record them so a restore knows what to build)
+enum ActorKind : unsigned char{
+    KIND_GHOST_RACER,
+    KIND_HUMAN_PED,
+    KIND_ZOMBIE_PED,
+    KIND_ZOMBIE_CAB,
+    KIND_HOLY_WATER_PROJECTILE,
+    KIND_BORDER_LINE,
+    KIND_OIL_SLICK,
+    KIND_HEALING_GOODIE,
+    KIND_HOLY_WATER_GOODIE,
+    KIND_SOUL_GOODIE,
+    NUM_ACTOR_KINDS
+};
+
+//everything that makes one actor what it is right now, flattened to plain values (world save states and replay keyframes).
+//laid out with no hidden padding so a whole record can be copied in and out of a save state in one go
+struct ActorState{
+    double          x;
+    double          y;
+    double          size;
+    double          vertSpeed;
+    double          horizSpeed;
+    int             imageID;                //tells yellow border lines from white ones
+    int             direction;
+    int             hitPoints;              //damageable kinds only
+    int             planDistance;           //enemies' movement plan distance
+    int             counter;                //GRacer: ammo, zombie ped: ticks until grunt, cab: 1 once it has damaged GRacer, projectile: travel distance left
+    unsigned int    animationNumber;
+    unsigned char   kind;                   //ActorKind
+    unsigned char   alive;
+    unsigned char   unused[6];              //explicit padding, always zero
+};
+
 class Actor: public GraphObject
 {
 public:
@@ -26,12 +60,25 @@ public:
     double getVertSpeed() const;
     double getHorizSpeed() const;
     virtual bool isAlive() const = 0;                               //MARK: PURE VIRTUAL, redefined separately for Environment and DamageableActors
+    virtual ActorKind getKind() const = 0;                          //MARK: PURE VIRTUAL, each fully derived class reports its own type tag
     
     //other public methods
     void doSomething();
     void hitByProjectile(const int& amt);
+    virtual void moveTo(double x, double y);                        //moves like any GraphObject but also tells the world when a CAW actor moves (for its lane index)
     virtual void killActor() = 0;                                   //MARK: PURE VIRTUAL, either set HP to zero or change bool member depending on specific class
     
+    //save states: each class fills in / takes back the part of the ActorState it owns, then hands on to its base
+    virtual void saveState(ActorState& state) const;
+    virtual void restoreState(const ActorState& state);               //the actor must already be of state's kind (and not yet added to the world)
+    
+    //RULES (ActorRules.h): how each class behaves, written once for both of StudentWorld's storage modes. A is the class
+    //itself (each method below just calls its rule with *this) or a row of column storage, which has the same methods
+    template <class A> static bool moveRelativeToRacer(A& a);
+    template <class A> static bool hasExitedScreen(const A& a);
+    template <class A> static void hitByProjectile(A& a, const int& amt);
+    template <class A> static void reactToProjectile(A& a, const int& amt);
+    
 protected:
     //protected getters
     StudentWorld* getWorld() const;
@@ -42,7 +89,7 @@ protected:
     
     //other protected methods:
     bool moveRelativeToRacer();                                     //all Actors other than GhostRacer will use this
-    bool hasExitedScreen();                                         //checks if actors have gone off the screen
+    bool hasExitedScreen() const;                                   //checks if actors have gone off the screen
     
 private:
     //basic state characteristics
@@ -69,6 +116,7 @@ public:
     
     virtual bool isAlive() const;                               //the isAlive method now simply checks the on/off life status
     virtual void killActor();                                   //killing an environment actor just involves setting its m_alive to false
+    virtual void restoreState(const ActorState& state);
 
 private:
     bool m_alive;                                        //Environment actors now track their alive status as on/off
@@ -92,6 +140,12 @@ public:
     //setters
     virtual void killActor();                                   //damageable actors are killed by setting hp to 0
     void getDamaged(const int& amt);
+    virtual void saveState(ActorState& state) const;
+    virtual void restoreState(const ActorState& state);
+    
+    //rules
+    template <class A> static void getDamaged(A& a, const int& amt);
+    template <class A> static void noHPLeft(A& /* a */){}
     
 protected:
     void setHP(const int& amt);
@@ -109,6 +163,10 @@ public:
     :Environment(imageID, x, y, dir, size, depth, vertSpeed, horizSpeed, affectedByProjectiles, myWorld)
     {}
     virtual ~Goodie(){}
+    
+    //rules
+    template <class A> static void actuallyDoSomething(A& a);
+    template <class A> static void extraMovements(A& /* a */){}
        
 private:
     virtual void actuallyDoSomething();
@@ -126,6 +184,13 @@ public:
     :DamageableActor(imageID, x, y, dir, size, depth, vertSpeed, horizSpeed, ENEMY_PROJECTILE_AFFECTED, myWorld, HP), movementPlanDistance(ENEMY_START_PLAN_DISTANCE), m_undead(zombieOrNot)
     {}
     virtual ~Enemy(){}
+    virtual void saveState(ActorState& state) const;
+    virtual void restoreState(const ActorState& state);
+    
+    //rules
+    template <class A> static void reactToProjectile(A& a, const int& amt);
+    template <class A> static void actuallyDoSomething(A& a);
+    template <class A> static void makeNewPedMovementPlan(A& a);
        
 protected:
     //protected getters and setters for the movement plan distance:
@@ -174,6 +239,7 @@ public:
     :DamageableActor(IID_GHOST_RACER, RACER_START_X, RACER_START_Y, RACER_START_DIR, RACER_START_SIZE, RACER_DEPTH, RACER_START_VERT_SPEED, RACER_START_HORIZ_SPEED, RACER_PROJECTILE_AFFECTED, myWorld, RACER_START_HP), m_holyWaterAmmo(RACER_START_AMMO)
     {}
     virtual ~GhostRacer(){}
+    virtual ActorKind getKind() const { return KIND_GHOST_RACER; }
     
     //public extra GhostRacer getters:
     unsigned int getAmmo() const;                               //the world and other objects could see Ghost Racer's ammo amount
@@ -182,6 +248,8 @@ public:
     void getSpun();                                             //ghost racer can be spun by oil slicks
     void getHealed(const int& amt);                             //GhostRacer can be healed by a certain amount
     void giveAmmo(const int& amt);                              //GhostRacer can gain ammo
+    virtual void saveState(ActorState& state) const;
+    virtual void restoreState(const ActorState& state);
     
 private:
     unsigned int            m_holyWaterAmmo;                    //GhostRacer now has ammo
@@ -212,6 +280,12 @@ public:
     :Enemy(IID_HUMAN_PED, x, y, HUMAN_START_DIR, HUMAN_START_SIZE, HUMAN_DEPTH, HUMAN_START_VERT_SPEED, HUMAN_START_HORIZ_SPEED, myWorld, HUMAN_START_HP, HUMAN_UNDEAD)
     {}
     virtual ~HumanPedestrian(){}
+    virtual ActorKind getKind() const { return KIND_HUMAN_PED; }
+    
+    //rules
+    template <class A> static bool messWithGhostRacer(A& a);
+    template <class A> static void planMovements(A& a);
+    template <class A> static void enemyWasHitByProjectile(A& a);
     
 private:
     virtual bool messWithGhostRacer();                      //redefined methods for general enemy pattern of do something
@@ -239,13 +313,25 @@ public:
     :Enemy(IID_ZOMBIE_PED, x, y, ZPED_START_DIR, ZPED_START_SIZE, ZPED_DEPTH, ZPED_START_VERT_SPEED, ZPED_START_HORIZ_SPEED, myWorld, ZPED_START_HP, ZPED_UNDEAD),  m_ticksUntilGrunt(ZPED_TICKS2GRUNT)
     {}
     virtual ~ZombiePedestrian(){}
+    virtual ActorKind getKind() const { return KIND_ZOMBIE_PED; }
+    virtual void saveState(ActorState& state) const;
+    virtual void restoreState(const ActorState& state);
      
-private:
     //score adder constant
     static constexpr int    KILLED_ZPED_SCORE_BONUS = 150;
     
+    //rules
+    template <class A> static bool messWithGhostRacer(A& a);
+    template <class A> static void planMovements(A& a);
+    template <class A> static void enemyWasHitByProjectile(A& a);
+    template <class A> static void noHPLeft(A& a);
+    
+private:
     int m_ticksUntilGrunt;                                  //zombie ped now tracks time until its next grunt
     
+    int getTicksUntilGrunt() const;
+    void setTicksUntilGrunt(const int& ticks);
+    
     virtual bool messWithGhostRacer();                      //redefined methods for the general enemy pattern of do something
     virtual void planMovements();
     virtual void enemyWasHitByProjectile();                 //zombies get hurt by projectile their own way
@@ -273,13 +359,26 @@ public:
     m_hasDamagedGhostRacer(ZCAB_START_DAMAGED_RACER)
     {}
     virtual ~ZombieCab(){}
+    virtual ActorKind getKind() const { return KIND_ZOMBIE_CAB; }
+    virtual void saveState(ActorState& state) const;
+    virtual void restoreState(const ActorState& state);
  
-private:
     //score adder constant
     static constexpr int    KILLED_CAB_SCORE_BONUS = 200;
+    
+    //rules
+    template <class A> static bool messWithGhostRacer(A& a);
+    template <class A> static void planMovements(A& a);
+    template <class A> static void enemyWasHitByProjectile(A& a);
+    template <class A> static void noHPLeft(A& a);
+    
+private:
     //private data
     bool m_hasDamagedGhostRacer;                            //zombie cabs now have a bool tracking whether they have damaged GRacer already
     
+    bool hasDamagedGhostRacer() const;
+    void setHasDamagedGhostRacer(const bool& damaged);
+    
     //private methods
     virtual bool messWithGhostRacer();                      //redefined methods for the general enemy pattern of do something
     virtual void planMovements();
@@ -304,10 +403,19 @@ public:
     :Environment(IID_HOLY_WATER_PROJECTILE, x, y, dir, PROJECTILE_START_SIZE, PROJECTILE_DEPTH, PROJECTILE_START_VERT_SPEED, PROJECTILE_START_HORIZ_SPEED, PROJECTILE_PROJECTILE_AFFECTED, myWorld), m_travelDistance(PROJECTILE_START_TRAVEL_DISTANCE)
     {}
     virtual ~HolyWaterProjectile(){}
+    virtual ActorKind getKind() const { return KIND_HOLY_WATER_PROJECTILE; }
+    virtual void saveState(ActorState& state) const;
+    virtual void restoreState(const ActorState& state);
+    
+    //rules
+    template <class A> static void actuallyDoSomething(A& a);
 
 private:
     int m_travelDistance;                                       //holy water projectiles now have a travel distance
     
+    int getTravelDistance() const;
+    void setTravelDistance(const int& distance);
+    
     virtual void actuallyDoSomething();                         //Holy Water Projectiles have a unique actuallyDoSomething()
 };
 
@@ -329,6 +437,10 @@ public:
     :Environment(imageID, x, y, BORDER_START_DIR, BORDER_START_SIZE, BORDER_DEPTH, BORDER_START_VERT_SPEED, BORDER_START_HORIZ_SPEED, BORDER_PROJECTILE_AFFECTED, myWorld)
     {}
     virtual ~BorderLine(){}
+    virtual ActorKind getKind() const { return KIND_BORDER_LINE; }
+    
+    //rules
+    template <class A> static void actuallyDoSomething(A& a);
 
 private:
     virtual void actuallyDoSomething();                         //BorderLine has its own actuallyDoSomething() which is the most simple
@@ -345,10 +457,12 @@ public:
     static constexpr bool   OIL_PROJECTILE_AFFECTED = false;
     //Oil Slicks must be specified with coords and world
     //they all have same image, 0 dir, a random int size b/t 2 and 5, depth 2, vert speed -4, horiz speed 0, are not affected by projectiles (or CAW like all env.)
-    OilSlick(const double& x, const double& y, StudentWorld* myWorld)
-    :Goodie(IID_OIL_SLICK, x, y, OIL_START_DIR, randInt(2,5), OIL_DEPTH, OIL_START_VERT_SPEED, OIL_START_HORIZ_SPEED, OIL_PROJECTILE_AFFECTED, myWorld)
-    {}
+    OilSlick(const double& x, const double& y, StudentWorld* myWorld);
     virtual ~OilSlick(){}
+    virtual ActorKind getKind() const { return KIND_OIL_SLICK; }
+    
+    //rules
+    template <class A> static void interactWithRacer(A& a);
     
 private:
     virtual void interactWithRacer();                           //oil slick will interact with racer by making her spin etc.
@@ -370,12 +484,16 @@ public:
     :Goodie(IID_HEAL_GOODIE, x, y, HEALGOODIE_START_DIR, HEALGOODIE_START_SIZE, HEALGOODIE_DEPTH, HEALGOODIE_START_VERT_SPEED, HEALGOODIE_START_HORIZ_SPEED, HEALGOODIE_PROJECTILE_AFFECTED, myWorld)
     {}
     virtual ~HealingGoodie(){}
+    virtual ActorKind getKind() const { return KIND_HEALING_GOODIE; }
     
-private:
     //score and health bonus constants
     static constexpr int    HEALGOODIE_HEALTH_BONUS = 10;
     static constexpr int    HEALGOODIE_SCORE_BONUS = 250;
     
+    //rules
+    template <class A> static void interactWithRacer(A& a);
+    
+private:
     virtual void interactWithRacer();                           //healing goodies will interact with racer by giving her health etc.
 };
 
@@ -395,12 +513,16 @@ public:
     :Goodie(IID_HOLY_WATER_GOODIE, x, y, HOLYWATERGOODIE_START_DIR, HOLYWATERGOODIE_START_SIZE, HOLYWATERGOODIE_DEPTH, HOLYWATERGOODIE_START_VERT_SPEED, HOLYWATERGOODIE_START_HORIZ_SPEED, HOLYWATERGOODIE_PROJECTILE_AFFECTED, myWorld)
     {}
     virtual ~HolyWaterGoodie(){}
+    virtual ActorKind getKind() const { return KIND_HOLY_WATER_GOODIE; }
     
-private:
     //score and ammo adder constants
     static constexpr int    HOLYWATER_AMMO_BONUS = 10;
     static constexpr int    HOLYWATER_SCORE_BONUS = 50;
     
+    //rules
+    template <class A> static void interactWithRacer(A& a);
+    
+private:
     virtual void interactWithRacer();                           //holy water goodies will interact with racer by giving her ammo etc.
 };
 
@@ -420,11 +542,16 @@ public:
     :Goodie(IID_SOUL_GOODIE, x, y, SOULGOODIE_START_DIR, SOULGOODIE_START_SIZE, SOULGOODIE_DEPTH, SOULGOODIE_START_VERT_SPEED, SOULGOODIE_START_HORIZ_SPEED, SOULGOODIE_PROJECTILE_AFFECTED, myWorld)
     {}
     virtual ~SoulGoodie(){}
+    virtual ActorKind getKind() const { return KIND_SOUL_GOODIE; }
     
-private:
     //score adder constant
     static constexpr int    SOULGOODIE_SCORE_BONUS = 100;
     
+    //rules
+    template <class A> static void interactWithRacer(A& a);
+    template <class A> static void extraMovements(A& a);
+    
+private:
     virtual void interactWithRacer();                           //Soul Goodies interactWithRacer by decreasing the world's souls to save etc.
     virtual void extraMovements();                              //Soul Goodie has extraMovements that it performs at the end of its dosomething (spinning)
 };
@@ -0,0 +1,77 @@
+#ifndef ACTORARENA_H_
+#define ACTORARENA_H_
+
+#include <vector>
+#include <memory>       //for std::unique_ptr holding the chunks
+#include <cstddef>      //for std::size_t and std::max_align_t
+
+//Level-scoped arena of fixed-size slots that every Actor in a StudentWorld is constructed in.
+//Chunks are only ever added, never returned, so once the arena has grown to a level's peak
+//population, spawning and killing actors reuses slots and never touches the heap.
+//reset() drops every slot at once WITHOUT running destructors, so the actors living in the
+//arena must not own anything that needs cleaning up (none of them do: they only hold numbers
+//and a pointer back to their world, and the world clears the display sets itself).
+class ActorArena
+{
+public:
+    static constexpr std::size_t SLOTS_PER_CHUNK = 64;
+
+    ActorArena(const std::size_t& slotSize)
+    :m_slotSize(roundUpToAlignment(slotSize)), m_freeList(nullptr), m_chunk(0), m_nextSlot(0)
+    {}
+
+    std::size_t slotSize() const{
+        return m_slotSize;
+    }
+
+    void* allocate(){                                       //hands out a recycled slot if there is one, otherwise the next untouched one
+        if (m_freeList != nullptr){
+            FreeSlot* slot = m_freeList;
+            m_freeList = slot->next;
+            return slot;
+        }
+        if (m_nextSlot == SLOTS_PER_CHUNK){                 //current chunk used up, move on to the next (allocating it only the first time)
+            m_chunk++;
+            m_nextSlot = 0;
+        }
+        if (m_chunk == m_chunks.size())
+            m_chunks.emplace_back(new unsigned char[m_slotSize * SLOTS_PER_CHUNK]);
+        void* slot = m_chunks[m_chunk].get() + m_slotSize * m_nextSlot;
+        m_nextSlot++;
+        return slot;
+    }
+
+    void release(void* p){                                  //slot goes back on the free list (object must already be destroyed)
+        FreeSlot* slot = static_cast<FreeSlot*>(p);
+        slot->next = m_freeList;
+        m_freeList = slot;
+    }
+
+    void reset(){                                           //forgets every slot in O(1), keeping the chunks for the next level
+        m_freeList = nullptr;
+        m_chunk = 0;
+        m_nextSlot = 0;
+    }
+
+private:
+    struct FreeSlot{
+        FreeSlot* next;
+    };
+
+    std::size_t                                         m_slotSize;
+    std::vector< std::unique_ptr<unsigned char[]> >     m_chunks;
+    FreeSlot*                                           m_freeList;     //intrusive list threaded through released slots
+    std::size_t                                         m_chunk;        //chunk new slots are currently carved from
+    std::size_t                                         m_nextSlot;     //next untouched slot in that chunk
+
+    static std::size_t roundUpToAlignment(const std::size_t& size){
+        const std::size_t align = alignof(std::max_align_t);
+        std::size_t atLeast = (size < sizeof(FreeSlot) ? sizeof(FreeSlot) : size);
+        return (atLeast + align - 1) / align * align;
+    }
+
+    ActorArena(const ActorArena&);                          //arenas own their slots, no copying
+    ActorArena& operator=(const ActorArena&);
+};
+
+#endif // ACTORARENA_H_
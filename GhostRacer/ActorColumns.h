@@ -0,0 +1,335 @@
+#ifndef ACTORCOLUMNS_H_
+#define ACTORCOLUMNS_H_
+
+#include "Actor.h"      //for ActorKind, ActorState and the classes whose rules rows follow
+#include "TrigTable.h"  //for cos, sin of whole-degree directions
+#include <vector>
+#include <cstddef>      //for std::size_t
+
+class StudentWorld;
+
+//what an actor of each kind is, for code that only has the kind tag (the constants come from the classes themselves)
+constexpr bool kindIsDamageable(const ActorKind& kind){
+    return kind == KIND_GHOST_RACER || kind == KIND_HUMAN_PED || kind == KIND_ZOMBIE_PED || kind == KIND_ZOMBIE_CAB;
+}
+constexpr bool kindIsCollisionAvoidanceWorthy(const ActorKind& kind){
+    return kindIsDamageable(kind) ? DamageableActor::DAMAGEABLE_ACTOR_CAW : Environment::ENV_CAW;
+}
+constexpr bool kindIsAffectedByProjectiles(const ActorKind& kind){
+    switch (kind)
+    {
+        case KIND_GHOST_RACER:              return GhostRacer::RACER_PROJECTILE_AFFECTED;
+        case KIND_HUMAN_PED:
+        case KIND_ZOMBIE_PED:
+        case KIND_ZOMBIE_CAB:               return Enemy::ENEMY_PROJECTILE_AFFECTED;
+        case KIND_HOLY_WATER_PROJECTILE:    return HolyWaterProjectile::PROJECTILE_PROJECTILE_AFFECTED;
+        case KIND_BORDER_LINE:              return BorderLine::BORDER_PROJECTILE_AFFECTED;
+        case KIND_OIL_SLICK:                return OilSlick::OIL_PROJECTILE_AFFECTED;
+        case KIND_HEALING_GOODIE:           return HealingGoodie::HEALGOODIE_PROJECTILE_AFFECTED;
+        case KIND_HOLY_WATER_GOODIE:        return HolyWaterGoodie::HOLYWATERGOODIE_PROJECTILE_AFFECTED;
+        case KIND_SOUL_GOODIE:              return SoulGoodie::SOULGOODIE_PROJECTILE_AFFECTED;
+        default:                            return false;
+    }
+}
+constexpr bool kindIsUndead(const ActorKind& kind){
+    switch (kind)
+    {
+        case KIND_HUMAN_PED:                return HumanPedestrian::HUMAN_UNDEAD;
+        case KIND_ZOMBIE_PED:               return ZombiePedestrian::ZPED_UNDEAD;
+        case KIND_ZOMBIE_CAB:               return ZombieCab::ZCAB_UNDEAD;
+        default:                            return false;
+    }
+}
+
+//Structure-of-arrays storage for the actors of a world in column storage (every actor but GRacer): row i of every column
+//describes the same actor, and rows are in update order. There are no Actor objects behind the rows, so the tick loop
+//streams through these arrays instead of chasing pointers. The columns are ActorState's fields, so a row saves and
+//restores exactly like the object it stands in for.
+struct ActorColumns
+{
+    std::vector<unsigned char>  kind;               //ActorKind, picks the rules the row follows
+    std::vector<unsigned char>  alive;              //damageable kinds: HP > 0, kept in step by ActorRow::setHP
+    std::vector<double>         x;
+    std::vector<double>         y;
+    std::vector<double>         size;
+    std::vector<double>         vertSpeed;
+    std::vector<double>         horizSpeed;
+    std::vector<int>            imageID;
+    std::vector<int>            direction;
+    std::vector<int>            hitPoints;          //damageable kinds only
+    std::vector<int>            planDistance;       //enemies' movement plan distance
+    std::vector<int>            counter;            //zombie ped: ticks until grunt, cab: 1 once it has damaged GRacer, projectile: travel distance left
+    std::vector<unsigned int>   animationNumber;
+
+    std::size_t rows() const{
+        return kind.size();
+    }
+
+    void clear(){
+        kind.clear(); alive.clear(); x.clear(); y.clear(); size.clear(); vertSpeed.clear(); horizSpeed.clear();
+        imageID.clear(); direction.clear(); hitPoints.clear(); planDistance.clear(); counter.clear(); animationNumber.clear();
+    }
+
+    void appendRow(const ActorState& state){
+        ActorKind rowKind = static_cast<ActorKind>(state.kind);
+        kind.push_back(state.kind);
+        alive.push_back(kindIsDamageable(rowKind) ? state.hitPoints > 0 : state.alive != 0);
+        x.push_back(state.x);
+        y.push_back(state.y);
+        size.push_back(state.size);
+        vertSpeed.push_back(state.vertSpeed);
+        horizSpeed.push_back(state.horizSpeed);
+        imageID.push_back(state.imageID);
+        direction.push_back(state.direction);
+        hitPoints.push_back(state.hitPoints);
+        planDistance.push_back(state.planDistance);
+        counter.push_back(state.counter);
+        animationNumber.push_back(state.animationNumber);
+    }
+
+    void saveRow(const std::size_t& row, ActorState& state) const{     //fills in state just like Actor::saveState would for the same actor
+        state = ActorState();
+        state.kind = kind[row];
+        state.alive = alive[row];
+        state.x = x[row];
+        state.y = y[row];
+        state.size = size[row];
+        state.vertSpeed = vertSpeed[row];
+        state.horizSpeed = horizSpeed[row];
+        state.imageID = imageID[row];
+        state.direction = direction[row];
+        state.hitPoints = hitPoints[row];
+        state.planDistance = planDistance[row];
+        state.counter = counter[row];
+        state.animationNumber = animationNumber[row];
+    }
+
+    void removeDeadRows(){                                              //survivors keep their order, like object storage's compaction
+        std::size_t firstDead = 0;
+        while (firstDead < rows() && alive[firstDead])
+            firstDead++;
+        if (firstDead == rows())
+            return;
+        compactColumn(kind, firstDead); compactColumn(x, firstDead); compactColumn(y, firstDead); compactColumn(size, firstDead);
+        compactColumn(vertSpeed, firstDead); compactColumn(horizSpeed, firstDead); compactColumn(imageID, firstDead);
+        compactColumn(direction, firstDead); compactColumn(hitPoints, firstDead); compactColumn(planDistance, firstDead);
+        compactColumn(counter, firstDead); compactColumn(animationNumber, firstDead);
+        compactColumn(alive, firstDead);                                //last, every other column is compacted by it
+    }
+
+private:
+    template <typename T>
+    void compactColumn(std::vector<T>& column, const std::size_t& firstDead){  //one column at a time, so each pass streams through a single array
+        std::size_t keep = firstDead;
+        for (std::size_t row = firstDead; row < column.size(); row++){
+            if (alive[row]){
+                column[keep] = column[row];
+                keep++;
+            }
+        }
+        column.resize(keep);
+    }
+};
+
+//One row of ActorColumns with the methods the rules in ActorRules.h call on an actor, whatever its kind. A row is
+//only a place in the columns: it is made on the spot wherever a row has to act and holds no state of its own
+class ActorRow
+{
+public:
+    ActorRow(ActorColumns& columns, const std::size_t& row, StudentWorld* world)
+    :m_columns(columns), m_row(row), m_world(world)
+    {}
+
+    std::size_t getRow() const{
+        return m_row;
+    }
+    StudentWorld* getWorld() const{
+        return m_world;
+    }
+
+    //what a GraphObject would say
+    double getX() const{
+        return m_columns.x[m_row];
+    }
+    double getY() const{
+        return m_columns.y[m_row];
+    }
+    double getSize() const{
+        return m_columns.size[m_row];
+    }
+    double getRadius() const{
+        return 8 * getSize();                                       //same radius per unit of size as GraphObject::getRadius
+    }
+    int getDirection() const{
+        return m_columns.direction[m_row];
+    }
+    void setDirection(int d){
+        while (d < 0)
+            d += 360;
+        m_columns.direction[m_row] = d % 360;
+    }
+    void moveTo(const double& x, const double& y){                  //counts as a move for the sprite's animation, like GraphObject::moveTo
+        m_columns.x[m_row] = x;
+        m_columns.y[m_row] = y;
+        m_columns.animationNumber[m_row]++;
+    }
+    void moveForward(const int& units){                             //GraphObject::moveAngle counts the move twice, so this does too
+        int dir = getDirection();
+        moveTo(getX() + units * TrigTable::cosDegrees(dir), getY() + units * TrigTable::sinDegrees(dir));
+        m_columns.animationNumber[m_row]++;
+    }
+
+    //Actor, DamageableActor and Enemy state
+    double getVertSpeed() const{
+        return m_columns.vertSpeed[m_row];
+    }
+    void setVertSpeed(const double& speed){
+        m_columns.vertSpeed[m_row] = speed;
+    }
+    double getHorizSpeed() const{
+        return m_columns.horizSpeed[m_row];
+    }
+    void setHorizSpeed(const double& speed){
+        m_columns.horizSpeed[m_row] = speed;
+    }
+    bool isAlive() const{
+        return m_columns.alive[m_row];
+    }
+    int getHP() const{
+        return m_columns.hitPoints[m_row];
+    }
+    void setHP(const int& amt){
+        m_columns.hitPoints[m_row] = amt;
+        m_columns.alive[m_row] = (amt > 0);
+    }
+    int getMovementPlanDistance() const{
+        return m_columns.planDistance[m_row];
+    }
+    void setMovementPlanDistance(const int& distance){
+        m_columns.planDistance[m_row] = distance;
+    }
+
+    //the counter column, under the name each kind that has one gives it
+    int getTicksUntilGrunt() const{
+        return m_columns.counter[m_row];
+    }
+    void setTicksUntilGrunt(const int& ticks){
+        m_columns.counter[m_row] = ticks;
+    }
+    bool hasDamagedGhostRacer() const{
+        return m_columns.counter[m_row] != 0;
+    }
+    void setHasDamagedGhostRacer(const bool& damaged){
+        m_columns.counter[m_row] = (damaged ? 1 : 0);
+    }
+    int getTravelDistance() const{
+        return m_columns.counter[m_row];
+    }
+    void setTravelDistance(const int& distance){
+        m_columns.counter[m_row] = distance;
+    }
+
+protected:
+    ActorColumns&   m_columns;
+    std::size_t     m_row;
+    StudentWorld*   m_world;
+};
+
+//the class whose rules an actor of kind K follows
+template <ActorKind K> struct ActorKindClass;
+template <> struct ActorKindClass<KIND_HUMAN_PED>{ typedef HumanPedestrian type; };
+template <> struct ActorKindClass<KIND_ZOMBIE_PED>{ typedef ZombiePedestrian type; };
+template <> struct ActorKindClass<KIND_ZOMBIE_CAB>{ typedef ZombieCab type; };
+template <> struct ActorKindClass<KIND_HOLY_WATER_PROJECTILE>{ typedef HolyWaterProjectile type; };
+template <> struct ActorKindClass<KIND_BORDER_LINE>{ typedef BorderLine type; };
+template <> struct ActorKindClass<KIND_OIL_SLICK>{ typedef OilSlick type; };
+template <> struct ActorKindClass<KIND_HEALING_GOODIE>{ typedef HealingGoodie type; };
+template <> struct ActorKindClass<KIND_HOLY_WATER_GOODIE>{ typedef HolyWaterGoodie type; };
+template <> struct ActorKindClass<KIND_SOUL_GOODIE>{ typedef SoulGoodie type; };
+
+//A row whose kind is known at compile time. Each step that an Actor would make a virtual call for is looked up in
+//K's class instead (Class::rule finds the same override the vtable would), so every kind gets its own update kernel
+template <ActorKind K>
+class ActorRowOf: public ActorRow
+{
+public:
+    ActorRowOf(ActorColumns& columns, const std::size_t& row, StudentWorld* world)
+    :ActorRow(columns, row, world)
+    {}
+
+    bool isAffectedByProjectiles() const{
+        return kindIsAffectedByProjectiles(K);
+    }
+    bool isUndead() const{
+        return kindIsUndead(K);
+    }
+    void killActor(){
+        if (kindIsDamageable(K))
+            setHP(0);                                               //damageable actors are killed by setting hp to 0
+        else
+            m_columns.alive[m_row] = false;
+    }
+
+    void actuallyDoSomething(){
+        Class::actuallyDoSomething(*this);
+    }
+    bool moveRelativeToRacer(){
+        return Class::moveRelativeToRacer(*this);
+    }
+    bool hasExitedScreen() const{
+        return Class::hasExitedScreen(*this);
+    }
+    void hitByProjectile(const int& amt){
+        Class::hitByProjectile(*this, amt);
+    }
+    void reactToProjectile(const int& amt){
+        Class::reactToProjectile(*this, amt);
+    }
+    void getDamaged(const int& amt){
+        Class::getDamaged(*this, amt);
+    }
+    void noHPLeft(){
+        Class::noHPLeft(*this);
+    }
+    void makeNewPedMovementPlan(){
+        Class::makeNewPedMovementPlan(*this);
+    }
+    bool messWithGhostRacer(){
+        return Class::messWithGhostRacer(*this);
+    }
+    void planMovements(){
+        Class::planMovements(*this);
+    }
+    void enemyWasHitByProjectile(){
+        Class::enemyWasHitByProjectile(*this);
+    }
+    void interactWithRacer(){
+        Class::interactWithRacer(*this);
+    }
+    void extraMovements(){
+        Class::extraMovements(*this);
+    }
+
+private:
+    typedef typename ActorKindClass<K>::type Class;
+};
+
+//calls f with the given row as an ActorRowOf its kind, which is how a row whose kind is only known at run time gets to act
+template <class F>
+void visitActorRow(ActorColumns& columns, const std::size_t& row, StudentWorld* world, F f){
+    switch (columns.kind[row])
+    {
+        case KIND_HUMAN_PED:            f(ActorRowOf<KIND_HUMAN_PED>(columns, row, world)); break;
+        case KIND_ZOMBIE_PED:           f(ActorRowOf<KIND_ZOMBIE_PED>(columns, row, world)); break;
+        case KIND_ZOMBIE_CAB:           f(ActorRowOf<KIND_ZOMBIE_CAB>(columns, row, world)); break;
+        case KIND_HOLY_WATER_PROJECTILE:f(ActorRowOf<KIND_HOLY_WATER_PROJECTILE>(columns, row, world)); break;
+        case KIND_BORDER_LINE:          f(ActorRowOf<KIND_BORDER_LINE>(columns, row, world)); break;
+        case KIND_OIL_SLICK:            f(ActorRowOf<KIND_OIL_SLICK>(columns, row, world)); break;
+        case KIND_HEALING_GOODIE:       f(ActorRowOf<KIND_HEALING_GOODIE>(columns, row, world)); break;
+        case KIND_HOLY_WATER_GOODIE:    f(ActorRowOf<KIND_HOLY_WATER_GOODIE>(columns, row, world)); break;
+        case KIND_SOUL_GOODIE:          f(ActorRowOf<KIND_SOUL_GOODIE>(columns, row, world)); break;
+        default:                        break;                                                      //GRacer is never a row, and restores refuse anything else
+    }
+}
+
+#endif // ACTORCOLUMNS_H_
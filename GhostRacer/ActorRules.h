@@ -0,0 +1,306 @@
+#ifndef ACTORRULES_H_
+#define ACTORRULES_H_
+
+#include "Actor.h"
+#include "StudentWorld.h"
+
+#include "GameConstants.h" //for road boundaries, sounds, etc.
+#include "TrigTable.h" //for cos, sin of whole-degree directions
+
+//What every kind of actor does, as templates over the actor A it is done to. Actor.cpp runs them on the Actor objects
+//of object storage (A is the class that owns the rule, so the steps that differ by kind are still virtual calls), and
+//StudentWorld runs them on the rows of column storage (A is an ActorRowOf<kind>, so every step is picked at compile time).
+//Both storage modes therefore play by the same rules, making the same calls in the same order.
+
+//***********************************************************************************************
+//ABSTRACT BASE CLASS ACTOR RULES:
+//***********************************************************************************************
+template <class A>
+bool Actor::moveRelativeToRacer(A& a){
+    double vert_speed = a.getVertSpeed() - a.getWorld()->getRacerSpeed();
+    double horiz_speed = a.getHorizSpeed();
+    double new_y = (a.getY() + vert_speed);
+    double new_x = (a.getX() + horiz_speed);
+    a.moveTo(new_x, new_y);
+    //if the border line has gone off the screen, it must be set to dead so studentworld can remove it
+    if (a.hasExitedScreen()){
+        a.killActor();
+        return false;           //false return to indicate doSomething should not be continued, actor is dead from moving
+    }
+    return true;
+}
+template <class A>
+bool Actor::hasExitedScreen(const A& a){
+    if ( a.getX() < 0 || a.getX() > VIEW_WIDTH || a.getY() < 0 || a.getY() > VIEW_HEIGHT )  //MARK: Think it should be width-1 and height-1 but following spec
+        return true;
+    return false;
+}
+template <class A>
+void Actor::hitByProjectile(A& a, const int& amt){
+    if (!a.isAlive() || !a.isAffectedByProjectiles())                     //if dead or not affected by projectiles return. just an extra check... should never be called in this manner the way the world projectileMaybeDamageActor is setup
+        return;
+    else
+        a.reactToProjectile(amt);
+}
+template <class A>
+void Actor::reactToProjectile(A& a, const int& /* amt */){             //most actors instantly die if they are hit by a projectile and are affected by projectiles. enemies react differently and have their own rule
+    if (a.isAffectedByProjectiles())
+        a.killActor();
+}
+
+//***********************************************************************************************
+//ABSTRACT BASE CLASS DAMAGEABLE ACTOR RULES:
+//***********************************************************************************************
+template <class A>
+void DamageableActor::getDamaged(A& a, const int& amt){
+    if (!a.isAlive())               //shouldn't be damaged if already dead
+        return;
+    a.setHP(a.getHP() - amt);       //otherwise decrement HP
+    if (!a.isAlive())
+        a.noHPLeft();               //do unique dying stuff (nothing by default, but zombie peds, cabs and GRacer have their own)
+}
+
+//***********************************************************************************************
+//ABSTRACT BASE CLASS ENEMY RULES:
+//***********************************************************************************************
+template <class A>
+void Enemy::reactToProjectile(A& a, const int& amt){
+    if (a.isUndead())
+        a.getDamaged(amt);      //enemies who are zombies will be damaged by holy water, when damaged they will further act a certain way automatically if killed
+    if (a.isAlive())
+        a.enemyWasHitByProjectile();        //they will do something else than the noHP method if they were hit but not killed. Human peds always just call this method
+}
+template <class A>
+void Enemy::actuallyDoSomething(A& a){
+    if ( a.messWithGhostRacer() )   //IF OVERLAPPING STUFF: enemies can 'mess' with the ghost racer if overlapping him
+        return;                     //if the enemy was overlapping the ghost racer, it does not move or plan movements, instant return
+    if (!a.moveRelativeToRacer())   //move relative to racer
+        return;                     //stop if died by moving off screen
+    a.planMovements();              //all enemies have movement plan stuff
+}
+template <class A>
+void Enemy::makeNewPedMovementPlan(A& a){
+    int pedHorizontalSpeed = 0;                                         //otherwise come up with a new speed from -3 to 3 NOT including 0
+    while (pedHorizontalSpeed == 0){
+        pedHorizontalSpeed = a.getWorld()->randInt(-3, 3);
+    }
+    a.setHorizSpeed(static_cast<double>(pedHorizontalSpeed));           //make a new movement plan with new speed
+    a.setMovementPlanDistance(a.getWorld()->randInt(4,32));             //and stick with it from 4 to 32 steps
+    if( a.getHorizSpeed() < 0 )                                         //re-orient the pedestrian to face in direction of movement
+        a.setDirection(180);
+    else
+        a.setDirection(0);
+}
+
+//***********************************************************************************************
+//ABSTRACT BASE CLASS GOODIE RULES:
+//***********************************************************************************************
+template <class A>
+void Goodie::actuallyDoSomething(A& a){
+    if ( !a.moveRelativeToRacer() )
+        return;                                 //return instantly if died going off screen
+    if (a.getWorld()->overlapWithRacer(a) && a.getWorld()->racerIsAlive())     //Goodies actually interact with the racer if they run into her and she's alive (even though student world immediately returns when racer dies, just added safety)
+        a.interactWithRacer();
+    a.extraMovements();                         //Some Goodies do extra movements after potentially interacting with the racer
+}
+
+//***********************************************************************************************
+//BORDER LINE RULES:
+//***********************************************************************************************
+template <class A>
+void BorderLine::actuallyDoSomething(A& a){
+    a.moveRelativeToRacer();
+}
+
+//***********************************************************************************************
+//HUMAN PEDESTRIAN RULES:
+//***********************************************************************************************
+template <class A>
+bool HumanPedestrian::messWithGhostRacer(A& a){
+    if ( a.getWorld()->overlapWithRacer(a) && a.getWorld()->racerIsAlive()){                      //rider instantly loses a life if it runs into a human pedestrian. extra check for racer being alive (unnecessary but added safety)
+        a.getWorld()->killRacer(); //world checks for death after every actor does something so it will notice and end level
+        return true;
+    }
+    return false;
+}
+template <class A>
+void HumanPedestrian::planMovements(A& a){
+    a.setMovementPlanDistance(a.getMovementPlanDistance() - 1);         //decrement movement plan distance
+
+    if (a.getMovementPlanDistance() > 0)                                //if still following a movement plan, done, stick w it
+        return;
+
+    a.makeNewPedMovementPlan();                                         //otherwise make a new pedestrian movement plan
+}
+template <class A>
+void HumanPedestrian::enemyWasHitByProjectile(A& a){        //run when hit by projectile and not dead (always the case for human peds being hit)
+    a.setHorizSpeed(a.getHorizSpeed() * -1);  //when hit by holy water human ped reverses direction
+    if( a.getHorizSpeed() < 0 )                        //re-orient the pedestrian to face in direction of movement
+        a.setDirection(180);
+    else
+        a.setDirection(0);
+    a.getWorld()->playSound(SOUND_PED_HURT);    //plays a sound that the ped was hurt
+}
+
+//***********************************************************************************************
+//ZOMBIE PEDESTRIAN RULES:
+//***********************************************************************************************
+template <class A>
+bool ZombiePedestrian::messWithGhostRacer(A& a){
+    if ( a.getWorld()->overlapWithRacer(a) && a.getWorld()->racerIsAlive()){                  //if overlapping with the racer, damage him by 5, damage zombie by 2. extra check for safety that racer is alive
+        a.getWorld()->damageRacer(5);
+        a.getDamaged(2);
+        return true;                    //immediately return, zombie is done messing with ghost racer cus its DEAD
+    }
+    int racer_x = a.getWorld()->getRacerX(), racer_y = a.getWorld()->getRacerY();           //otherwise...
+    if ( (a.getX() >= racer_x - 30 && a.getX() <= racer_x + 30) && a.getY() > racer_y ){    //if less than or equal to 30 pixels left or right of racer and above racer
+        a.setDirection(270);
+        if ( a.getX() < racer_x )               //move right if to left of racer
+            a.setHorizSpeed(1);
+        else if ( a.getX() > racer_x )          //move left if to right of racer
+            a.setHorizSpeed(-1);
+        else
+            a.setHorizSpeed(0);
+        a.setTicksUntilGrunt(a.getTicksUntilGrunt() - 1);      //decrease # of ticks until next grunt
+        if (a.getTicksUntilGrunt() <= 0){                       //if ready to grunt
+            a.getWorld()->playSound(SOUND_ZOMBIE_ATTACK);       //make grunt sound and rest ticks until next grunt to 20
+            a.setTicksUntilGrunt(20);
+        }
+    }
+    return false;           //keep going with do something, still alive for now
+}
+template <class A>
+void ZombiePedestrian::planMovements(A& a){
+    if (a.getMovementPlanDistance() > 0){                       //if we still have time on the old movement plan, decrememnt that time and return
+        a.setMovementPlanDistance(a.getMovementPlanDistance()-1);
+        return;
+    }
+    //otherwise, make a new movement plan
+    a.makeNewPedMovementPlan();
+}
+template <class A>
+void ZombiePedestrian::enemyWasHitByProjectile(A& a){
+    a.getWorld()->playSound(SOUND_PED_HURT);
+}
+template <class A>
+void ZombiePedestrian::noHPLeft(A& a){
+    //auto-set to not alive by HP becoming 0, not needed here
+    a.getWorld()->playSound(SOUND_PED_DIE);
+    if ( !a.getWorld()->overlapWithRacer(a) ){      //if zombie was killed by projectile and not overlapping racer
+        if ( a.getWorld()->randInt(0,4) == 0 )          //1 in 5 chance
+            a.getWorld()->template addNewActor<HealingGoodie>(a.getX(), a.getY(), a.getWorld());      //add a new healing goodie at zombies location
+    }
+    a.getWorld()->increaseScore(KILLED_ZPED_SCORE_BONUS);       //player gets 150 points
+}
+
+//***********************************************************************************************
+//ZOMBIE CAB RULES:
+//***********************************************************************************************
+template <class A>
+bool ZombieCab::messWithGhostRacer(A& a){
+    if ( a.getWorld()->overlapWithRacer(a) && a.getWorld()->racerIsAlive() && !a.hasDamagedGhostRacer()){    //if overlapping with the racer and racer is alive and hasn't damaged racer yet (skip to movement via false return)
+        a.getWorld()->playSound(SOUND_VEHICLE_CRASH);       //play crash and damage racer by 20 hp
+        a.getWorld()->damageRacer(20);
+        if (a.getX() <= a.getWorld()->getRacerX() ){        //if left of racer veer off road to left
+            a.setHorizSpeed(-5);
+            a.setDirection(120 + a.getWorld()->randInt(0,19));
+        }
+        else{                                               //if right of racer veer off road to right
+            a.setHorizSpeed(5);
+            a.setDirection(60 - a.getWorld()->randInt(0,19));
+        }
+        a.setHasDamagedGhostRacer(true);                    //remember now that it has damaged ghost racer
+    }
+    return false;
+}
+template <class A>
+void ZombieCab::planMovements(A& a){
+    double pixelsFront(VIEW_HEIGHT), pixelsBack(-VIEW_HEIGHT);
+    a.getWorld()->closestCAWActorsInLane(a.getX(), a.getY(), pixelsFront, pixelsBack);     //check to see where the closest ALIVE CAW actors in front or behind the cab are. default would be VIEW_HEIGHT pixels in front if no actors in front and -VIEW_HEIGHT pixels behind if no actors behind. DOES NOT include Ghost Racer
+    if ( a.getVertSpeed() > a.getWorld()->getRacerSpeed() && pixelsFront < 96){       //if non-GR CAW actor <96 pixels in front, slow down .5
+        a.setVertSpeed(a.getVertSpeed() - 0.5);
+        return;     //immediately return in this case
+    }
+    else if ( a.getVertSpeed() <= a.getWorld()->getRacerSpeed() && pixelsBack > -96 ){ //if non-GR CAW actor <96 pixels behind, speed up .5
+        a.setVertSpeed(a.getVertSpeed() + 0.5);
+        return;     //immediately return in this case
+    }
+    //otherwise...
+    a.setMovementPlanDistance(a.getMovementPlanDistance()-1);       //decrement movement plan distance
+    if (a.getMovementPlanDistance() > 0)
+        return;     //stick with movement plan
+
+    //otherwise, it's time for a new movement plan
+    a.setMovementPlanDistance(a.getWorld()->randInt(4,32));
+    a.setVertSpeed(a.getVertSpeed() + a.getWorld()->randInt(-2,2));
+}
+template <class A>
+void ZombieCab::enemyWasHitByProjectile(A& a){
+    a.getWorld()->playSound(SOUND_VEHICLE_HURT);
+}
+template <class A>
+void ZombieCab::noHPLeft(A& a){
+    //life status automatically updated by HP
+    a.getWorld()->playSound(SOUND_VEHICLE_DIE);
+    if ( a.getWorld()->randInt(0,4) == 0 )          //1 in 5 chance
+        a.getWorld()->template addNewActor<OilSlick>(a.getX(), a.getY(), a.getWorld());      //add a new oil slick at zombies location
+    a.getWorld()->increaseScore(KILLED_CAB_SCORE_BONUS);
+}
+
+//***********************************************************************************************
+//GOODIE RULES:
+//***********************************************************************************************
+template <class A>
+void OilSlick::interactWithRacer(A& a){
+    a.getWorld()->playSound(SOUND_OIL_SLICK);
+    a.getWorld()->spinRacer();
+}
+template <class A>
+void HealingGoodie::interactWithRacer(A& a){
+    a.getWorld()->healRacer(HEALGOODIE_HEALTH_BONUS);
+    a.killActor();
+    a.getWorld()->playSound(SOUND_GOT_GOODIE);
+    a.getWorld()->increaseScore(HEALGOODIE_SCORE_BONUS);
+}
+template <class A>
+void HolyWaterGoodie::interactWithRacer(A& a){
+    a.getWorld()->giveRacerAmmo(HOLYWATER_AMMO_BONUS);
+    a.killActor();
+    a.getWorld()->playSound(SOUND_GOT_GOODIE);
+    a.getWorld()->increaseScore(HOLYWATER_SCORE_BONUS);
+}
+template <class A>
+void SoulGoodie::interactWithRacer(A& a){
+    a.getWorld()->saveASoul();
+    a.killActor();
+    a.getWorld()->playSound(SOUND_GOT_SOUL);
+    a.getWorld()->increaseScore(SOULGOODIE_SCORE_BONUS);
+}
+template <class A>
+void SoulGoodie::extraMovements(A& a){
+    a.setDirection(a.getDirection()-10);    //rotate by 10 degrees clockwise
+}
+
+//***********************************************************************************************
+//HOLY WATER PROJECTILE RULES:
+//***********************************************************************************************
+template <class A>
+void HolyWaterProjectile::actuallyDoSomething(A& a)
+{
+    //if activated
+    if ( a.getWorld()->projectileMaybeDamageActor(a)){
+        a.killActor();          //projectile kills itself if it found an affected AND ALIVE actor overlapping it and attempted to damage the actor
+        return;     //return immediately
+    }
+    //otherwise keep the projectile moving
+    a.moveForward(SPRITE_HEIGHT);
+    a.setTravelDistance(a.getTravelDistance() - SPRITE_HEIGHT);     //decrement its range/travel distance MARK: Assumed we should decrement by this amount to match the sample game range
+    if (a.hasExitedScreen()){     //if it's gone off the screen, must be marked to be killed
+        a.killActor();
+        return;     //return immediately
+    }
+    if (a.getTravelDistance() <= 0)
+        a.killActor();              //mark projectile for death if it has now traveled 160 pixels
+}
+
+#endif // ACTORRULES_H_
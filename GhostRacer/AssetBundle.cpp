@@ -0,0 +1,220 @@
+#include "AssetBundle.h"
+#include "GameAssets.h"
+#include "StateStream.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+using namespace std;
+
+static const uint32_t BUNDLE_MAGIC = 0x42415247;	// "GRAB"
+static const uint32_t BUNDLE_VERSION = 1;
+
+const char* const AssetBundle::FILE_NAME = "GhostRacer.bundle";
+
+static uint64_t alignedTo(uint64_t offset, uint64_t alignment)
+{
+	return (offset + alignment - 1) / alignment * alignment;
+}
+
+static bool readWholeFile(string path, string& contents)
+{
+	ifstream ifs(path, ios::binary);
+	if (!ifs)
+		return false;
+	ostringstream oss;
+	oss << ifs.rdbuf();
+	contents = oss.str();
+	return static_cast<bool>(ifs);
+}
+
+bool AssetBundle::write(string path, string assetPath)
+{
+	vector<SpriteAtlas::Frame> frames(NUM_GAME_SPRITES);
+	for (size_t k = 0; k < NUM_GAME_SPRITES; k++)
+	{
+		frames[k].imageID = GAME_SPRITES[k].imageID;
+		frames[k].frameNum = GAME_SPRITES[k].frameNum;
+		if (!SpriteAtlas::loadTga(assetPath + GAME_SPRITES[k].tgaFileName, frames[k]))
+		{
+			cout << "Cannot read sprite " << assetPath + GAME_SPRITES[k].tgaFileName << endl;
+			return false;
+		}
+	}
+	SpriteAtlas atlas;
+	if (!atlas.build(frames, SpriteAtlas::MAX_WIDTH))
+	{
+		cout << "The sprites don't fit in a " << SpriteAtlas::MAX_WIDTH << "x"
+			 << SpriteAtlas::MAX_WIDTH << " atlas" << endl;
+		return false;
+	}
+
+	  // each WAV once, however many sounds play it; a missing one is left
+	  // out, as the game plays nothing for a sound it can't find anyway
+	vector<string> soundNames;
+	vector<string> soundData;
+	for (size_t k = 0; k < NUM_GAME_SOUNDS; k++)
+	{
+		string name = GAME_SOUNDS[k].wavFileName;
+		if (find(soundNames.begin(), soundNames.end(), name) != soundNames.end())
+			continue;
+		if (name.size() >= sizeof(SoundEntry().name))
+		{
+			cout << "Sound file name too long: " << name << endl;
+			return false;
+		}
+		string data;
+		if (!readWholeFile(assetPath + name, data))
+		{
+			cout << "Cannot read sound " << assetPath + name << "; leaving it out" << endl;
+			continue;
+		}
+		soundNames.push_back(name);
+		soundData.push_back(data);
+	}
+
+	Header header;
+	header.magic = BUNDLE_MAGIC;
+	header.version = BUNDLE_VERSION;
+	header.atlasWidth = atlas.width();
+	header.atlasHeight = atlas.height();
+	header.numLevels = atlas.numLevels();
+	header.levelsOffset = sizeof(Header);
+	header.numFrames = atlas.placements().size();
+	header.framesOffset = alignedTo(header.levelsOffset + header.numLevels * sizeof(LevelEntry), 8);
+	header.numSounds = soundNames.size();
+	header.soundsOffset = alignedTo(header.framesOffset + header.numFrames * sizeof(SpriteAtlas::Placement), 8);
+
+	  // the blobs after the tables, each on its own boundary
+	uint64_t offset = header.soundsOffset + header.numSounds * sizeof(SoundEntry);
+	vector<LevelEntry> levels(atlas.numLevels());
+	for (size_t k = 0; k < levels.size(); k++)
+	{
+		levels[k].offset = offset = alignedTo(offset, BLOB_ALIGNMENT);
+		levels[k].size = atlas.level(k).size();
+		offset += levels[k].size;
+	}
+	vector<SoundEntry> sounds(soundNames.size());
+	for (size_t k = 0; k < sounds.size(); k++)
+	{
+		memset(sounds[k].name, 0, sizeof(sounds[k].name));
+		strcpy(sounds[k].name, soundNames[k].c_str());
+		sounds[k].offset = offset = alignedTo(offset, BLOB_ALIGNMENT);
+		sounds[k].size = soundData[k].size();
+		offset += sounds[k].size;
+	}
+
+	StateWriter out;
+	out.reserve(static_cast<size_t>(offset));
+	out.put(header);
+	for (size_t k = 0; k < levels.size(); k++)
+		out.put(levels[k]);
+	out.align(8);
+	for (size_t k = 0; k < atlas.placements().size(); k++)
+		out.put(atlas.placements()[k]);
+	out.align(8);
+	for (size_t k = 0; k < sounds.size(); k++)
+		out.put(sounds[k]);
+	for (size_t k = 0; k < levels.size(); k++)
+	{
+		out.align(BLOB_ALIGNMENT);
+		out.putBytes(atlas.level(k).data(), atlas.level(k).size());
+	}
+	for (size_t k = 0; k < sounds.size(); k++)
+	{
+		out.align(BLOB_ALIGNMENT);
+		out.putBytes(soundData[k].data(), soundData[k].size());
+	}
+
+	ofstream ofs(path, ios::binary);
+	if (ofs)
+		ofs.write(reinterpret_cast<const char*>(out.data()), out.size());
+	if (!ofs)
+	{
+		cout << "Cannot write asset bundle " << path << endl;
+		return false;
+	}
+	return true;
+}
+
+AssetBundle::AssetBundle()
+{
+	m_header = Header();
+}
+
+  // Maps the bundle and checks that everything its tables point to lies
+  // inside the file, so nothing read from it later needs checking again.
+bool AssetBundle::open(string path)
+{
+	close();
+	if (!m_file.open(path))
+		return false;
+
+	StateReader in(m_file.data(), m_file.size());
+	uint64_t size = m_file.size();
+	bool ok = in.get(m_header)  &&  m_header.magic == BUNDLE_MAGIC  &&  m_header.version == BUNDLE_VERSION
+		&&  m_header.numLevels > 0  &&  m_header.numLevels <= 64
+		&&  m_header.levelsOffset + m_header.numLevels * sizeof(LevelEntry) <= size
+		&&  m_header.numFrames <= size  &&  m_header.framesOffset + m_header.numFrames * sizeof(SpriteAtlas::Placement) <= size
+		&&  m_header.numSounds <= size  &&  m_header.soundsOffset + m_header.numSounds * sizeof(SoundEntry) <= size;
+	for (size_t k = 0; ok  &&  k < numLevels(); k++)
+	{
+		LevelEntry level = entry<LevelEntry>(m_header.levelsOffset, k);
+		uint64_t expected = static_cast<uint64_t>(SpriteAtlas::levelSize(m_header.atlasWidth, k))
+							* SpriteAtlas::levelSize(m_header.atlasHeight, k) * 4;
+		ok = level.size == expected  &&  level.offset <= size  &&  level.size <= size - level.offset;
+	}
+	for (size_t k = 0; ok  &&  k < m_header.numSounds; k++)
+	{
+		SoundEntry sound = entry<SoundEntry>(m_header.soundsOffset, k);
+		ok = sound.name[sizeof(sound.name) - 1] == '\0'  &&  sound.offset <= size  &&  sound.size <= size - sound.offset;
+	}
+	if (!ok)
+	{
+		close();
+		return false;
+	}
+	return true;
+}
+
+void AssetBundle::close()
+{
+	m_file.close();
+	m_header = Header();
+}
+
+const unsigned char* AssetBundle::level(size_t k) const
+{
+	return m_file.data() + entry<LevelEntry>(m_header.levelsOffset, k).offset;
+}
+
+SpriteAtlas::Placement AssetBundle::frame(size_t k) const
+{
+	return entry<SpriteAtlas::Placement>(m_header.framesOffset, k);
+}
+
+bool AssetBundle::findSound(const string& wavFileName, const unsigned char*& data, size_t& size) const
+{
+	for (size_t k = 0; k < m_header.numSounds; k++)
+	{
+		SoundEntry sound = entry<SoundEntry>(m_header.soundsOffset, k);
+		if (wavFileName == sound.name)
+		{
+			data = m_file.data() + sound.offset;
+			size = static_cast<size_t>(sound.size);
+			return true;
+		}
+	}
+	return false;
+}
+
+  // Entry k of a table, copied out (the tables are only 8-byte aligned)
+template <typename T>
+T AssetBundle::entry(uint64_t tableOffset, size_t k) const
+{
+	T value;
+	memcpy(&value, m_file.data() + tableOffset + k * sizeof(T), sizeof(T));
+	return value;
+}
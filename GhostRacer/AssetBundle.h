@@ -0,0 +1,116 @@
+#ifndef ASSETBUNDLE_H_
+#define ASSETBUNDLE_H_
+
+#include "MappedFile.h"
+#include "SpriteAtlas.h"
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+  // Every asset the game uses in one file, ready to use as it lies on
+  // disk.  The file holds
+  //
+  //	a fixed header (atlas size, how many of everything, where it all is),
+  //	a table of mipmap levels (size and offset of each),
+  //	where each sprite frame is in the atlas (SpriteAtlas::Placement),
+  //	a table of sounds (file name, size and offset of each), and
+  //	the atlas, every mipmap level of it, and the WAV files themselves,
+  //	each starting on a BLOB_ALIGNMENT boundary.
+  //
+  // GhostRacerBundle writes it from the Assets directory, with
+  // the atlas packed and its mipmaps made the way SpriteManager would at
+  // startup.  The game maps it (through a MappedFile) and hands OpenGL the
+  // levels straight from the mapping, so starting up reads no TGA files
+  // and makes no mipmaps.  Like save states, the tables are raw values, so
+  // a bundle is only read by a build for the same kind of machine.
+
+class AssetBundle
+{
+  public:
+	  // What the game looks for in its asset directory
+	static const char* const FILE_NAME;
+
+	static const std::size_t BLOB_ALIGNMENT = 4096;		// a page, so each blob maps on its own
+
+	  // Packs the sprites and sounds in GameAssets.h, read from assetPath
+	  // (a directory name ending in '/', or empty for the current one), into
+	  // the bundle path.  Returns false, saying why on cout, if a sprite
+	  // can't be read or path can't be written; missing sounds are left out.
+	static bool write(std::string path, std::string assetPath);
+
+	AssetBundle();
+
+	bool open(std::string path);
+	void close();
+
+	bool isOpen() const
+	{
+		return m_file.isOpen();
+	}
+
+	unsigned int atlasWidth() const
+	{
+		return m_header.atlasWidth;
+	}
+
+	unsigned int atlasHeight() const
+	{
+		return m_header.atlasHeight;
+	}
+
+	  // Mipmap level k of the atlas, BGRA, SpriteAtlas::levelSize of the
+	  // atlas size on a side; level 0 is the atlas itself.
+	std::size_t numLevels() const
+	{
+		return static_cast<std::size_t>(m_header.numLevels);
+	}
+
+	const unsigned char* level(std::size_t k) const;
+
+	std::size_t numFrames() const
+	{
+		return static_cast<std::size_t>(m_header.numFrames);
+	}
+
+	SpriteAtlas::Placement frame(std::size_t k) const;
+
+	  // The WAV file packed under the name wavFileName, in place; returns
+	  // false if there is none.
+	bool findSound(const std::string& wavFileName, const unsigned char*& data, std::size_t& size) const;
+
+  private:
+	struct Header
+	{
+		std::uint32_t	magic;
+		std::uint32_t	version;
+		std::uint32_t	atlasWidth;
+		std::uint32_t	atlasHeight;
+		std::uint64_t	numLevels;
+		std::uint64_t	levelsOffset;
+		std::uint64_t	numFrames;
+		std::uint64_t	framesOffset;
+		std::uint64_t	numSounds;
+		std::uint64_t	soundsOffset;
+	};
+
+	struct LevelEntry
+	{
+		std::uint64_t	offset;
+		std::uint64_t	size;
+	};
+
+	struct SoundEntry
+	{
+		char			name[48];		// NUL-terminated
+		std::uint64_t	offset;
+		std::uint64_t	size;
+	};
+
+	MappedFile	m_file;
+	Header		m_header;
+
+	template <typename T>
+	T entry(std::uint64_t tableOffset, std::size_t k) const;
+};
+
+#endif // ASSETBUNDLE_H_
@@ -0,0 +1,152 @@
+#include "Autopilot.h"
+#include "GameWorld.h"
+#include "GameConstants.h"
+#include "StudentWorld.h"
+#include "WorldController.h"
+#include <string>
+#include <cmath>
+#include <limits>
+using namespace std;
+
+static const int NO_KEY = 0;
+static const int CANDIDATE_KEYS[] = {
+	NO_KEY, KEY_PRESS_LEFT, KEY_PRESS_RIGHT, KEY_PRESS_UP, KEY_PRESS_DOWN, KEY_PRESS_SPACE
+};
+static const int SEARCH_DEPTH = 2;		// branch on every key at the start and halfway
+
+static const double DEATH_VALUE = -1e9;
+static const double VALUE_PER_TICK_SURVIVED = 1e4;		// dying later is better than dying sooner
+static const double FINISHED_LEVEL_VALUE = 1e6;
+static const double VALUE_PER_HIT_POINT = 10;
+static const double VALUE_PER_PIXEL_OFF_CENTER = -0.5;
+
+  // Controller for the scratch worlds: hands the world one key on the first
+  // tick it asks, and otherwise does nothing.
+class RolloutController : public WorldController
+{
+  public:
+	RolloutController()
+	 : m_key(NO_KEY)
+	{
+	}
+
+	void press(int key)
+	{
+		m_key = key;
+	}
+
+	virtual bool getLastKey(int& value)
+	{
+		if (m_key == NO_KEY)
+			return false;
+		value = m_key;
+		m_key = NO_KEY;
+		return true;
+	}
+
+	virtual void playSound(int /* soundID */) {}
+	virtual void quitGame() {}
+	virtual void setMsPerTick(int /* ms_per_tick */) {}
+
+  private:
+	int m_key;
+};
+
+static RolloutController& rolloutController()
+{
+	thread_local RolloutController controller;		// autopilots on different threads each get their own
+	return controller;
+}
+
+Autopilot::Autopilot(WorldFactory makeWorld, int lookahead)
+ : m_makeWorld(makeWorld), m_lookahead(lookahead < SEARCH_DEPTH ? SEARCH_DEPTH : lookahead),
+   m_clones(0), m_ticks(0)
+{
+}
+
+Autopilot::~Autopilot()
+{
+	for (size_t k = 0; k < m_scratch.size(); k++)
+		delete m_scratch[k];
+}
+
+int Autopilot::chooseKey(const GameWorld& world)
+{
+	if (m_scratch.empty())
+	{
+		for (int level = 0; level < SEARCH_DEPTH; level++)
+		{
+			GameWorld* gw = m_makeWorld();
+			gw->graphObjects().setTracking(false);
+			gw->setController(&rolloutController());
+			m_scratch.push_back(gw);
+		}
+	}
+
+	int firstTicks = m_lookahead / SEARCH_DEPTH;
+	int restTicks = m_lookahead - firstTicks;
+	long startTick = world.getTick();
+	int bestKey = NO_KEY;
+	double bestValue = -numeric_limits<double>::infinity();
+	for (int key : CANDIDATE_KEYS)
+	{
+		GameWorld* line = m_scratch[0];
+		if (!world.cloneInto(line))
+			return NO_KEY;
+		m_clones++;
+		int status = simulate(line, key, firstTicks);
+		double value;
+		if (status != GWSTATUS_CONTINUE_GAME)
+			value = evaluate(*line, status, line->getTick() - startTick);
+		else
+		{
+			value = -numeric_limits<double>::infinity();
+			for (int nextKey : CANDIDATE_KEYS)
+			{
+				GameWorld* branch = m_scratch[1];
+				line->cloneInto(branch);
+				m_clones++;
+				int branchStatus = simulate(branch, nextKey, restTicks);
+				value = max(value, evaluate(*branch, branchStatus, branch->getTick() - startTick));
+			}
+		}
+		if (value > bestValue)		// ties go to the earlier key, so no key when nothing is better
+		{
+			bestValue = value;
+			bestKey = key;
+		}
+	}
+	return bestKey;
+}
+
+  // Steps gw up to ticks times, pressing key on the first, and stops early
+  // if the racer dies or the level ends.  Returns the last step's status.
+int Autopilot::simulate(GameWorld* gw, int key, int ticks)
+{
+	rolloutController().press(key);
+	int status = GWSTATUS_CONTINUE_GAME;
+	for (int t = 0; t < ticks  &&  status == GWSTATUS_CONTINUE_GAME; t++)
+	{
+		status = gw->step();
+		m_ticks++;
+	}
+	rolloutController().press(NO_KEY);
+	return status;
+}
+
+  // How good it is to have got to gw, ticks into the line, ending with status
+double Autopilot::evaluate(const GameWorld& gw, int status, long ticks) const
+{
+	if (status == GWSTATUS_PLAYER_DIED)
+		return DEATH_VALUE + VALUE_PER_TICK_SURVIVED * ticks;
+	double value = gw.getScore();
+	if (status == GWSTATUS_FINISHED_LEVEL)
+		value += FINISHED_LEVEL_VALUE;
+	const StudentWorld* sw = dynamic_cast<const StudentWorld*>(&gw);
+	if (sw != nullptr)
+	{
+		value += VALUE_PER_HIT_POINT * sw->getRacerHP();
+		value += VALUE_PER_PIXEL_OFF_CENTER * abs(sw->getRacerX() - ROAD_CENTER);
+	}
+	return value;
+}
@@ -0,0 +1,66 @@
+#ifndef AUTOPILOT_H_
+#define AUTOPILOT_H_
+
+#include <vector>
+#include <functional>
+
+class GameWorld;
+
+  // Drives Ghost Racer by looking ahead.  Before each tick it copies the
+  // world into a scratch world (GameWorld::cloneInto), tries every key
+  // (none, left, right, up, down, fire) and simulates the copy a few dozen
+  // ticks on, branching on every key again halfway; the first key of the
+  // best line is the one pressed.  A line is judged on whether the racer
+  // survives it, then on score, the racer's health and how close to the
+  // middle of the road it ends up.
+  //
+  // The scratch worlds are made once and reused for every copy, never
+  // displayed (their display registry doesn't track anything) and run with
+  // a controller that drops sounds, so a search costs copies and ticks and
+  // nothing else.  The search is deterministic, so a game played by the
+  // autopilot is as repeatable, and as recordable, as one played from a
+  // key script.
+
+class Autopilot
+{
+  public:
+	using WorldFactory = std::function<GameWorld*()>;
+
+	static const int DEFAULT_LOOKAHEAD = 24;
+
+	  // makeWorld makes the scratch worlds, which must be the same kind of
+	  // world as the ones being driven.  The autopilot owns them.
+	explicit Autopilot(WorldFactory makeWorld, int lookahead = DEFAULT_LOOKAHEAD);
+	~Autopilot();
+
+	  // The key to press on world's next tick, or 0 for none.  world must be
+	  // between ticks with a level running: after init(), before step().
+	int chooseKey(const GameWorld& world);
+
+	  // Work done by every chooseKey so far
+	long clonesMade() const
+	{
+		return m_clones;
+	}
+
+	long ticksSimulated() const
+	{
+		return m_ticks;
+	}
+
+  private:
+	WorldFactory			m_makeWorld;
+	int						m_lookahead;
+	std::vector<GameWorld*>	m_scratch;		// one per level of the search
+	long					m_clones;
+	long					m_ticks;
+
+	int simulate(GameWorld* gw, int key, int ticks);
+	double evaluate(const GameWorld& gw, int status, long ticks) const;
+
+	  // Prevent copying or assigning autopilots
+	Autopilot(const Autopilot&);
+	Autopilot& operator=(const Autopilot&);
+};
+
+#endif // AUTOPILOT_H_
@@ -0,0 +1,59 @@
+#include "Checkpoint.h"
+#include "GameWorld.h"
+#include "MappedFile.h"
+#include <fstream>
+#include <cstdio>
+using namespace std;
+
+static const uint32_t CHECKPOINT_MAGIC = 0x50435247;	// "GRCP"
+static const uint32_t CHECKPOINT_VERSION = 1;
+
+bool Checkpoint::save(string path, const GameWorld& gw, bool needInit)
+{
+	m_buffer.clear();
+	gw.saveState(m_buffer);
+
+	Header header;
+	header.magic = CHECKPOINT_MAGIC;
+	header.version = CHECKPOINT_VERSION;
+	header.needInit = needInit;
+	header.stateSize = m_buffer.size();
+	header.checksum = stateChecksum(m_buffer.data(), m_buffer.size());
+
+	string tmpPath = path + ".tmp";
+	{
+		ofstream ofs(tmpPath, ios::binary);
+		if (!ofs)
+			return false;
+		ofs.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+		ofs.write(reinterpret_cast<const char*>(m_buffer.data()), m_buffer.size());
+		if (!ofs.flush())
+			return false;
+	}
+#ifdef _MSC_VER
+	remove(path.c_str());		// rename won't replace an existing file here
+#endif
+	return rename(tmpPath.c_str(), path.c_str()) == 0;
+}
+
+bool Checkpoint::load(string path, GameWorld* gw, bool& needInit)
+{
+	MappedFile file;
+	if (!file.open(path))
+		return false;
+
+	StateReader in(file.data(), file.size());
+	Header header;
+	if (!in.get(header)  ||  header.magic != CHECKPOINT_MAGIC  ||  header.version != CHECKPOINT_VERSION
+		||  header.stateSize != file.size() - sizeof(Header))
+		return false;
+	const unsigned char* state = in.getBytes(header.stateSize);
+	if (state == nullptr  ||  stateChecksum(state, header.stateSize) != header.checksum)
+		return false;
+
+	StateReader stateIn(state, header.stateSize);
+	if (!gw->restoreState(stateIn))
+		return false;
+	needInit = (header.needInit != 0);
+	return true;
+}
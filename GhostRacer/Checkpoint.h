@@ -0,0 +1,47 @@
+#ifndef CHECKPOINT_H_
+#define CHECKPOINT_H_
+
+#include "StateStream.h"
+#include <string>
+
+class GameWorld;
+
+  // A world's save state kept in a file, so a long run can be picked up
+  // again after the process is restarted or has crashed.  The file is a
+  // small header (what it is, whether the world is between levels, how
+  // long the state is and a checksum of it) followed by the save state.
+  //
+  // A checkpoint is written to path.tmp and then renamed over path, so a
+  // crash part way through a write leaves the previous checkpoint intact.
+  // The buffer the state is built in is kept from one save to the next,
+  // so taking checkpoints every so often costs one copy of the world and
+  // one file write, nothing more.
+
+class Checkpoint
+{
+  public:
+	  // Writes gw's state to path.  needInit says gw is between levels (its
+	  // next tick starts with init()), as HeadlessController's tick callback
+	  // reports it.  Returns false if the file can't be written.
+	bool save(std::string path, const GameWorld& gw, bool needInit);
+
+	  // Restores gw from the checkpoint at path and sets needInit for
+	  // HeadlessController::resume.  Returns false if the file is missing,
+	  // damaged or not a checkpoint this build wrote; gw is then left with
+	  // no level running.
+	static bool load(std::string path, GameWorld* gw, bool& needInit);
+
+  private:
+	struct Header
+	{
+		std::uint32_t	magic;
+		std::uint32_t	version;
+		std::uint64_t	needInit;
+		std::uint64_t	stateSize;
+		std::uint64_t	checksum;	// stateChecksum of the state bytes
+	};
+
+	StateWriter		m_buffer;
+};
+
+#endif // CHECKPOINT_H_
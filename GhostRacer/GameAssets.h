@@ -0,0 +1,63 @@
+#ifndef GAMEASSETS_H_
+#define GAMEASSETS_H_
+
+#include "GameConstants.h"
+#include <cstddef>
+
+  // Every sprite frame and sound the game uses and the file it comes from
+  // in the Assets directory, for the game to load and for GhostRacerBundle
+  // to pack.
+
+struct SpriteAsset
+{
+	int			imageID;
+	int			frameNum;
+	const char*	tgaFileName;
+};
+
+struct SoundAsset
+{
+	int			soundID;
+	const char*	wavFileName;
+};
+
+const SpriteAsset GAME_SPRITES[] = {
+	{ IID_GHOST_RACER	 , 0, "redcar.tga" },
+	{ IID_WHITE_BORDER_LINE	 , 0, "white-lane.tga" },
+	{ IID_YELLOW_BORDER_LINE , 0, "yellow-lane.tga" },
+	{ IID_OIL_SLICK	, 0, "oil.tga" },
+	{ IID_HUMAN_PED	, 0, "dude_1.tga" },
+	{ IID_HUMAN_PED	, 1, "dude_2.tga" },
+	{ IID_HUMAN_PED	, 2, "dude_3.tga" },
+	{ IID_ZOMBIE_PED	, 0, "zombie_1.tga" },
+	{ IID_ZOMBIE_PED	, 1, "zombie_2.tga" },
+	{ IID_ZOMBIE_PED	, 2, "zombie_3.tga" },
+	{ IID_ZOMBIE_CAB		   , 0, "yellow.tga" },
+	{ IID_HOLY_WATER_PROJECTILE	   , 0, "water1.tga" },
+	{ IID_HOLY_WATER_PROJECTILE	   , 1, "water2.tga" },
+	{ IID_HOLY_WATER_PROJECTILE	   , 2, "water3.tga" },
+	{ IID_HEAL_GOODIE  , 0, "health.tga"},
+	{ IID_HOLY_WATER_GOODIE  , 0, "holy_water.tga"},
+	{ IID_SOUL_GOODIE  , 0, "soul.tga"},
+};
+
+const SoundAsset GAME_SOUNDS[] = {
+	{ SOUND_PED_HURT			, "hurt.wav" },
+	{ SOUND_VEHICLE_HURT        , "hurt.wav" },
+	{ SOUND_VEHICLE_CRASH        , "crash.wav" },
+	{ SOUND_PLAYER_DIE             , "die.wav" },
+	{ SOUND_OIL_SLICK             , "skid.wav" },
+	{ SOUND_FINISHED_LEVEL		   , "finished.wav" },
+	{ SOUND_PLAYER_SPRAY		   , "squirt.wav" },
+	{ SOUND_VEHICLE_DIE			   , "zombiedie.wav" },
+	{ SOUND_PED_DIE					, "zombiedie.wav" },
+	{ SOUND_THEME					, "theme.wav" },
+	{ SOUND_GOT_GOODIE		    , "goodie.wav" },
+	{ SOUND_GOT_SOUL		    , "bell.wav" },
+	{ SOUND_ZOMBIE_ATTACK		, "attack.wav" }
+};
+
+const std::size_t NUM_GAME_SPRITES = sizeof(GAME_SPRITES) / sizeof(GAME_SPRITES[0]);
+const std::size_t NUM_GAME_SOUNDS = sizeof(GAME_SOUNDS) / sizeof(GAME_SOUNDS[0]);
+
+#endif // GAMEASSETS_H_
@@ -3,9 +3,6 @@
 #ifndef GAMECONSTANTS_H_
 #define GAMECONSTANTS_H_
 
-#include <random>
-#include <utility>
-
 // image IDs for the game objects
 
 const int IID_GHOST_RACER = 0;
@@ -76,17 +73,4 @@ const int GWSTATUS_LEVEL_ERROR    = 4;
 
 const int NUM_TEST_PARAMS = 1;
 
-// Return a uniformly distributed random int from min to max, inclusive
-
-inline
-int randInt(int min, int max)
-{
-    if (max < min)
-        std::swap(max, min);
-    static std::random_device rd;
-    static std::default_random_engine generator(rd());
-    std::uniform_int_distribution<> distro(min, max);
-    return distro(generator);
-}
-
 #endif // GAMECONSTANTS_H_
@@ -2,16 +2,21 @@
 
 #include "freeglut.h"
 #include "GameController.h"
+#include "Autopilot.h"
 #include "GameWorld.h"
 #include "GameConstants.h"
 #include "GraphObject.h"
 #include "SoundFX.h"
 #include "SpriteManager.h"
+#include "GameAssets.h"
+#include "GameView.h"
 #include <string>
 #include <map>
 #include <utility>
 #include <cstdlib>
 #include <algorithm>
+#include <charconv>
+#include <thread>
 using namespace std;
 
 /*
@@ -32,97 +37,88 @@ PixelHeight = RowHeight/256 = .03375
 newSpriteHeight = PixelHeight * NumPixels
 */
 
-static const int WINDOW_WIDTH = 768; //1024;
-static const int WINDOW_HEIGHT = 768;
-
-static const int PERSPECTIVE_NEAR_PLANE = 4;
-static const int PERSPECTIVE_FAR_PLANE	= 22;
-
-static const double VISIBLE_MIN_X = -2.39;
-static const double VISIBLE_MAX_X = 2.1; // 2.39;
-static const double VISIBLE_MIN_Y = -2.1;
-static const double VISIBLE_MAX_Y = 1.9;
-static const double VISIBLE_MIN_Z = -20;
-// static const double VISIBLE_MAX_Z = -6;
-
 static const double FONT_SCALEDOWN = 760.0;
 
 static const double SCORE_Y = 3.8;
 static const double SCORE_Z = -10;
 
 static const int MS_PER_FRAME = 5;
+static const int MAX_IDLE_MS_PER_FRAME = 250;	// how far the timer backs off while a prompt waits
+static const int MAX_TICKS_PER_FRAME = 8;		// catch-up limit; lag past this is dropped, not run
+static const int MAX_KEY_AGE_MS = 250;			// older unread key presses are dropped
 
 int GameController::m_ms_per_tick = kDefaultMsPerTick;
 
-struct SpriteInfo
-{
-	unsigned int imageID;
-	unsigned int frameNum;
-	std::string	 tgaFileName;
-};
-
-static void convertToGlutCoords(double x, double y, double& gx, double& gy, double& gz);
-static void drawPrompt(string mainMessage, string secondMessage);
-static void drawScoreAndLives(string);
+static void drawPrompt(StrokeText lines[2], const string& mainMessage, const string& secondMessage);
+static void drawScoreAndLives(StatusLineText& line, const RenderSnapshot& snapshot);
 
 enum GameController::GameControllerState : int {
-    welcome, contgame, finishedlevel, init, cleanup, makemove, animate, gameover, prompt, quit, not_applicable
+    welcome, contgame, finishedlevel, init, cleanup, makemove, gameover, prompt, quit, not_applicable
 };
 
+  // Keys come off m_keys oldest first, one per call (the world asks at
+  // most once a tick).  During play only keys pressed by the time of the
+  // tick being simulated are handed out, so when several ticks run in one
+  // frame to catch up, each gets the keys of its own moment rather than
+  // the first one getting them all; a key that has waited more than
+  // MAX_KEY_AGE_MS by then (say while the racer was bouncing off the edge
+  // of the road and ignoring the keyboard) is dropped instead of steering
+  // long after the fact.  Presses are never overwritten by later ones.
+bool GameController::getLastKey(int& value)
+{
+	if (m_autopilot != nullptr  &&  m_gameState == makemove)
+	{
+		  // the autopilot steers; the keyboard still answers prompts
+		m_keys.clear();
+		if (m_autopilotKey == INVALID_KEY)
+			return false;
+		value = m_autopilotKey;
+		m_autopilotKey = INVALID_KEY;
+		return true;
+	}
+
+	KeyQueue::Clock::time_point deadline = (m_gameState == makemove ? m_keyDeadline : KeyQueue::Clock::now());
+	KeyQueue::Event event;
+	while (m_keys.peek(event))
+	{
+		if (event.time > deadline)
+			return false;		// it belongs to a later tick
+		m_keys.pop();
+		if (deadline - event.time <= std::chrono::milliseconds(MAX_KEY_AGE_MS))
+		{
+			value = event.key;
+			return true;
+		}
+	}
+	return false;
+}
+
+  // Sprites come from the asset bundle if there is one, uploaded as they
+  // lie in it; otherwise from the TGA files, packed here.
 void GameController::initDrawersAndSounds()
 {
-	SpriteInfo drawers[] = {
-		{ IID_GHOST_RACER	 , 0, "redcar.tga" },
-		{ IID_WHITE_BORDER_LINE	 , 0, "white-lane.tga" },
-		{ IID_YELLOW_BORDER_LINE , 0, "yellow-lane.tga" },
-		{ IID_OIL_SLICK	, 0, "oil.tga" },
-		{ IID_HUMAN_PED	, 0, "dude_1.tga" },
-		{ IID_HUMAN_PED	, 1, "dude_2.tga" },
-		{ IID_HUMAN_PED	, 2, "dude_3.tga" },
-		{ IID_ZOMBIE_PED	, 0, "zombie_1.tga" },
-		{ IID_ZOMBIE_PED	, 1, "zombie_2.tga" },
-		{ IID_ZOMBIE_PED	, 2, "zombie_3.tga" },
-		{ IID_ZOMBIE_CAB		   , 0, "yellow.tga" },
-		{ IID_HOLY_WATER_PROJECTILE	   , 0, "water1.tga" },
-		{ IID_HOLY_WATER_PROJECTILE	   , 1, "water2.tga" },
-		{ IID_HOLY_WATER_PROJECTILE	   , 2, "water3.tga" },
-		{ IID_HEAL_GOODIE  , 0, "health.tga"},
-		{ IID_HOLY_WATER_GOODIE  , 0, "holy_water.tga"},
-		{ IID_SOUL_GOODIE  , 0, "soul.tga"},
-	};
-
-	SoundMapType::value_type sounds[] = {
-		make_pair(SOUND_PED_HURT			, "hurt.wav"),
-		make_pair(SOUND_VEHICLE_HURT        ,"hurt.wav"),
-		make_pair(SOUND_VEHICLE_CRASH        ,"crash.wav"),
-		make_pair(SOUND_PLAYER_DIE             , "die.wav"),
-		make_pair(SOUND_OIL_SLICK             , "skid.wav"),
-		make_pair(SOUND_FINISHED_LEVEL		   , "finished.wav"),
-		make_pair(SOUND_PLAYER_SPRAY		   , "squirt.wav"),
-		make_pair(SOUND_VEHICLE_DIE			   , "zombiedie.wav"),
-		make_pair(SOUND_PED_DIE					, "zombiedie.wav"),
-		make_pair(SOUND_THEME					, "theme.wav"),
-		make_pair(SOUND_GOT_GOODIE		    , "goodie.wav"),
-		make_pair(SOUND_GOT_SOUL		    , "bell.wav"),
-		make_pair(SOUND_ZOMBIE_ATTACK		, "attack.wav")
-	};
-
-	for (int k = 0; k < sizeof(drawers)/sizeof(drawers[0]); k++)
+	string path = m_gw->assetPath();
+	if (!path.empty())
+		path += '/';
+
+	if (!m_assets.open(path + AssetBundle::FILE_NAME)  ||  !m_spriteManager.loadAtlas(m_assets))
 	{
-		string path = m_gw->assetPath();
-		if (!path.empty())
-			path += '/';
-		const SpriteInfo& d = drawers[k];
-		if (!m_spriteManager.loadSprite(path + d.tgaFileName, d.imageID, d.frameNum))
+		for (size_t k = 0; k < NUM_GAME_SPRITES; k++)
+		{
+			const SpriteAsset& d = GAME_SPRITES[k];
+			if (!m_spriteManager.loadSprite(path + d.tgaFileName, d.imageID, d.frameNum))
+				exit(0);
+		}
+		if (!m_spriteManager.buildAtlas())
 			exit(0);
 	}
-	for (int k = 0; k < sizeof(sounds)/sizeof(sounds[0]); k++)
-		m_soundMap[sounds[k].first] = sounds[k].second;
+	for (size_t k = 0; k < NUM_GAME_SOUNDS; k++)
+		m_soundMap[GAME_SOUNDS[k].soundID] = GAME_SOUNDS[k].wavFileName;
 }
 
-static void doSomethingCallback()
+static void displayCallback()
 {
-	Game().doSomething();
+	Game().displayEvent();
 }
 
 static void reshapeCallback(int w, int h)
@@ -140,10 +136,276 @@ static void specialKeyboardEventCallback(int key, int x, int y)
 	Game().specialKeyboardEvent(key, x, y);
 }
 
-void GameController::timerFuncCallback(int)
+void GameController::timerFuncCallback(int generation)
+{
+	GameController& game = Game();
+	if (generation != game.m_timerGeneration)
+		return;		// a key or resize started a new timer since this one was set
+	game.render();
+    glutTimerFunc(game.nextTimerDelay(), timerFuncCallback, generation);
+}
+
+  // While a prompt is up and nothing has happened, there is nothing to do
+  // but wait for a key, so each timer waits twice as long as the last (up
+  // to MAX_IDLE_MS_PER_FRAME) and the idle game barely uses the CPU.
+int GameController::nextTimerDelay()
+{
+	if (m_snapshots.front().screen == RenderSnapshot::PROMPT  &&  !m_promptNeedsDrawing)
+		m_timerMs = std::min(2 * m_timerMs, MAX_IDLE_MS_PER_FRAME);
+	else
+		m_timerMs = MS_PER_FRAME;
+	return m_timerMs;
+}
+
+  // Something happened: get back to the full frame rate now rather than
+  // when the backed-off timer fires.  The pending timer can't be cancelled,
+  // so it is left to fire and ignore itself.
+void GameController::wakeUp()
+{
+	if (m_snapshots.front().screen == RenderSnapshot::PROMPT)
+		m_promptNeedsDrawing = true;
+	if (m_timerMs > MS_PER_FRAME)
+	{
+		m_timerMs = MS_PER_FRAME;
+		m_timerGeneration++;
+		glutTimerFunc(MS_PER_FRAME, timerFuncCallback, m_timerGeneration);
+	}
+}
+
+  // Tell the simulation thread, if it is waiting at a prompt or for the
+  // next single step, to look at the keys and flags again.  Taking the
+  // lock, even for nothing, orders this after its check of them, so the
+  // wakeup can't slip in between the check and the wait.
+void GameController::wakeSimulation()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_wakeMutex);
+	}
+	m_wakeCondition.notify_one();
+}
+
+  // The simulation runs on its own clock: every m_ms_per_tick of real
+  // (monotonic) time is owed one tick, however often the timer manages to
+  // fire, so the game runs at the same speed on a loaded machine as on an
+  // idle one.  A frame that arrives late runs the ticks it missed, up to
+  // MAX_TICKS_PER_FRAME; anything more (the window was dragged, a debugger
+  // stopped us) is forgotten rather than fast-forwarded.
+void GameController::restartTickClock()
+{
+	m_lastTickTime = std::chrono::steady_clock::now();
+	m_tickLag = std::chrono::milliseconds(m_ms_per_tick);	// the first tick is due at once
+}
+
+int GameController::ticksDue()
+{
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	if (m_singleStep)
+	{
+		  // one tick per key, and no lag building up while we wait for it.
+		  // The key is taken off the queue here, not through getLastKey,
+		  // which under autopilot throws the keyboard's keys away.
+		m_lastTickTime = now;
+		m_tickLag = std::chrono::steady_clock::duration::zero();
+		m_keyDeadline = now;
+		KeyQueue::Event event;
+		if (!m_keys.peek(event))
+			return 0;
+		m_keys.pop();
+		return 1;
+	}
+
+	const std::chrono::steady_clock::duration tick = std::chrono::milliseconds(std::max(m_ms_per_tick, 1));
+	m_tickLag += now - m_lastTickTime;
+	m_lastTickTime = now;
+	long long due = m_tickLag / tick;
+	m_tickLag -= due * tick;
+	if (due > MAX_TICKS_PER_FRAME)
+		due = MAX_TICKS_PER_FRAME;
+	return static_cast<int>(due);
+}
+
+  // How far real time has got into the tick after the one snapshot shows,
+  // 0 to 1, for drawing objects part way along their last move.
+double GameController::tickProgress(const RenderSnapshot& snapshot) const
+{
+	if (!snapshot.interpolate)
+		return 1;		// show exactly where the tick left things
+	double progress = std::chrono::duration<double>(std::chrono::steady_clock::now() - snapshot.tickTime)
+						/ std::chrono::milliseconds(std::max(snapshot.msPerTick, 1));
+	return std::max(0.0, std::min(progress, 1.0));
+}
+
+  // Runs the ticks that are due and publishes where the last of them left
+  // the world (only the newest snapshot is ever drawn, so the ones before
+  // it would be copied for nothing).  Stops early if the racer dies or the
+  // level ends (m_nextStateAfterAnimate says which); returns how many ran.
+int GameController::runDueTicks()
+{
+	m_nextStateAfterAnimate = not_applicable;
+	int ticks = ticksDue();
+	if (ticks == MAX_TICKS_PER_FRAME)
+		m_catchUpLimitHits++;
+	const std::chrono::steady_clock::duration tick = std::chrono::milliseconds(std::max(m_ms_per_tick, 1));
+	std::chrono::steady_clock::time_point lastDue = m_lastTickTime - m_tickLag;	// when the last of them fell due
+	int ran = 0;
+	for ( ; ran < ticks  &&  m_nextStateAfterAnimate == not_applicable; ran++)
+	{
+		m_keyDeadline = lastDue - (ticks - 1 - ran) * tick;
+		m_gw->graphObjects().settleAnimations();
+		if (m_autopilot != nullptr)
+			m_autopilotKey = m_autopilot->chooseKey(*m_gw);
+		int status = m_gw->step();
+		if (status == GWSTATUS_PLAYER_DIED)
+		{
+			  // animate one last frame so the Ego can see what happened
+			m_nextStateAfterAnimate = (m_gw->isGameOver() ? gameover : contgame);
+		}
+		else if (status == GWSTATUS_FINISHED_LEVEL)
+		{
+			m_gw->advanceToNextLevel();
+			  // animate one last frame so the Ego can see what happened
+			m_nextStateAfterAnimate = finishedlevel;
+		}
+	}
+	if (ran > 0)
+		publishPlay();
+	return ran;
+}
+
+  // Copies what the window needs out of the world, as the last tick left
+  // it, into the free snapshot and hands it to the GLUT thread.
+void GameController::publishPlay()
+{
+	RenderSnapshot& snapshot = m_snapshots.back();
+	snapshot.screen = RenderSnapshot::PLAY;
+	snapshot.sprites.clear();
+	for (int i = GraphObjectRegistry::NUM_DEPTHS - 1; i >= 0; --i)
+	{
+		const std::vector<GraphObject*>& graphObjects = m_gw->graphObjects().getGraphObjects(i);
+
+		for (std::size_t k = 0; k < graphObjects.size(); k++)
+		{
+			GraphObject* cur = graphObjects[k];
+			if (cur->isVisible())
+			{
+				RenderSnapshot::Sprite sprite;
+				sprite.imageID = cur->getID();
+				sprite.animationNumber = cur->getAnimationNumber();
+				cur->getAnimationLocation(sprite.fromX, sprite.fromY, 0);
+				cur->getAnimationLocation(sprite.x, sprite.y);
+				sprite.direction = cur->getDirection();
+				sprite.size = cur->getSize();
+				sprite.depth = i;
+				snapshot.sprites.push_back(sprite);
+			}
+		}
+	}
+
+	  // just the numbers; the GLUT thread turns them into text if it draws them
+	snapshot.numStatusFields = m_gw->numStatusFields();
+	std::copy(m_gw->statusFields(), m_gw->statusFields() + snapshot.numStatusFields, snapshot.status);
+	snapshot.tickTime = m_keyDeadline;
+	snapshot.msPerTick = m_ms_per_tick;
+	snapshot.interpolate = !m_singleStep;
+	snapshot.catchUpLimitHits = m_catchUpLimitHits;
+	m_snapshots.publish();
+}
+
+void GameController::publishPrompt()
+{
+	RenderSnapshot& snapshot = m_snapshots.back();
+	snapshot.screen = RenderSnapshot::PROMPT;
+	snapshot.sprites.clear();
+	snapshot.mainMessage = m_mainMessage;
+	snapshot.secondMessage = m_secondMessage;
+	snapshot.catchUpLimitHits = m_catchUpLimitHits;
+	m_snapshots.publish();
+}
+
+  // The simulation thread: runs the game state machine until it quits.
+void GameController::simulate()
+{
+	while (!m_simulationDone)
+	{
+		if (m_quitRequested)
+			setGameState(quit);
+		doSomething();
+		waitForWork();
+	}
+}
+
+  // Between steps of the state machine, the simulation thread sleeps until
+  // there is something to do: the next tick during play, a key at a prompt
+  // or in single-step mode.  Quitting cuts any wait short except the sleep
+  // to the next tick, which is never longer than a tick.
+void GameController::waitForWork()
+{
+	if (m_gameState == makemove  &&  !m_singleStep)
+	{
+		const std::chrono::steady_clock::duration tick = std::chrono::milliseconds(std::max(m_ms_per_tick, 1));
+		std::this_thread::sleep_until(m_lastTickTime + (tick - m_tickLag));
+	}
+	else if (m_gameState == prompt  ||  m_gameState == makemove)
+	{
+		bool stepping = (m_gameState == makemove);
+		std::unique_lock<std::mutex> lock(m_wakeMutex);
+		m_wakeCondition.wait(lock, [this, stepping] {
+			KeyQueue::Event event;
+			return m_quitRequested  ||  m_keys.peek(event)  ||  (stepping  &&  !m_singleStep);
+		});
+	}
+}
+
+  // The GLUT thread's frame: draw the newest snapshot the simulation has
+  // published.  A prompt is drawn only when it is new or the window needs
+  // it; play is drawn every frame, interpolated toward the next tick,
+  // unless the governor says the host can't afford it right now.
+void GameController::render()
+{
+	if (m_simulationDone)
+	{
+		glutLeaveMainLoop();
+		return;
+	}
+
+	bool fresh = m_snapshots.update();
+	const RenderSnapshot& snapshot = m_snapshots.front();
+	switch (snapshot.screen)
+	{
+		case RenderSnapshot::BLANK:
+			break;
+		case RenderSnapshot::PROMPT:
+			if (fresh  ||  m_promptNeedsDrawing)
+			{
+				drawPrompt(m_promptLines, snapshot.mainMessage, snapshot.secondMessage);
+				m_promptNeedsDrawing = false;
+			}
+			break;
+		case RenderSnapshot::PLAY:
+			{
+				bool caughtUpToLimit = (snapshot.catchUpLimitHits != m_governorCatchUpLimitHits);
+				m_governorCatchUpLimitHits = snapshot.catchUpLimitHits;
+
+				double lagTicks = std::chrono::duration<double>(std::chrono::steady_clock::now() - snapshot.tickTime)
+									/ std::chrono::milliseconds(std::max(snapshot.msPerTick, 1));
+				if (!snapshot.interpolate)
+					displayGamePlay(snapshot);
+				else if (m_governor.shouldDraw(caughtUpToLimit, lagTicks, snapshot.msPerTick))
+				{
+					auto drawStart = std::chrono::steady_clock::now();
+					displayGamePlay(snapshot);
+					m_governor.recordDrawTime(std::chrono::duration<double, std::milli>(
+											std::chrono::steady_clock::now() - drawStart).count());
+				}
+			}
+			break;
+	}
+}
+
+void GameController::displayEvent()
 {
-	Game().doSomething();
-    glutTimerFunc(MS_PER_FRAME, timerFuncCallback, 0);
+	m_promptNeedsDrawing = true;
+	render();
 }
 
 void GameController::run(int argc, char* argv[], GameWorld* gw, string windowTitle)
@@ -151,10 +413,17 @@ void GameController::run(int argc, char* argv[], GameWorld* gw, string windowTit
 	gw->setController(this);
 	m_gw = gw;
 	setGameState(welcome);
-	m_lastKeyHit = INVALID_KEY;
+	m_keys.clear();
 	m_singleStep = false;
-	m_curIntraFrameTick = 0;
+	m_quitRequested = false;
+	m_simulationDone = false;
 	m_playerWon = false;
+	m_autopilotKey = INVALID_KEY;
+	m_catchUpLimitHits = 0;
+	m_promptNeedsDrawing = true;
+	m_timerGeneration = 0;
+	m_timerMs = MS_PER_FRAME;
+	m_governorCatchUpLimitHits = 0;
 
 	glutInit(&argc, argv);
 
@@ -168,40 +437,75 @@ void GameController::run(int argc, char* argv[], GameWorld* gw, string windowTit
 	glutKeyboardFunc(keyboardEventCallback);
 	glutSpecialFunc(specialKeyboardEventCallback);
 	glutReshapeFunc(reshapeCallback);
-	glutDisplayFunc(doSomethingCallback);
-	glutTimerFunc(MS_PER_FRAME, timerFuncCallback, 0);
+	glutDisplayFunc(displayCallback);
+	glutTimerFunc(MS_PER_FRAME, timerFuncCallback, m_timerGeneration);
 
 	glutSetOption(GLUT_ACTION_ON_WINDOW_CLOSE, GLUT_ACTION_GLUTMAINLOOP_RETURNS);
+	if (!m_recordPath.empty())
+		gw->startRecording(&m_inputLog);
+
+	  // from here until the join the world belongs to the simulation thread
+	m_simulationThread = std::thread(&GameController::simulate, this);
+
 	glutMainLoop();
+
+	  // the window may have been closed with the game still going
+	m_quitRequested = true;
+	wakeSimulation();
+	m_simulationThread.join();
+
+	if (m_governor.framesSkipped() > 0)
+		cout << "Skipped drawing " << m_governor.framesSkipped() << " of "
+			 << m_governor.framesSkipped() + m_governor.framesDrawn() << " frames to keep up"
+			 << " (drawing averaged " << m_governor.averageDrawMs() << " ms a frame)" << endl;
+
+	if (!m_recordPath.empty())
+	{
+		m_gw->stopRecording();
+		if (!m_inputLog.save(m_recordPath))
+			cout << "Cannot write input log " << m_recordPath << endl;
+	}
 	delete m_gw;
 }
 
 void GameController::keyboardEvent(unsigned char key, int /* x */, int /* y */)
 {
+	KeyQueue::Clock::time_point now = KeyQueue::Clock::now();
+	int hit = INVALID_KEY;
 	switch (key)
 	{
-		case 'a': case '4': m_lastKeyHit = KEY_PRESS_LEFT;	break;
-		case 'd': case '6': m_lastKeyHit = KEY_PRESS_RIGHT; break;
-		case 'w': case '8': m_lastKeyHit = KEY_PRESS_UP;	break;
-		case 's': case '2': m_lastKeyHit = KEY_PRESS_DOWN;	break;
-		case 't':			m_lastKeyHit = KEY_PRESS_TAB;	break;
-		case 'f':			m_singleStep = true;			break;
-		case 'r':			m_singleStep = false;			break;
-		case 'q': case 'Q': setGameState(quit);				break;
-		default:			m_lastKeyHit = key;				break;
+		case 'a': case '4': hit = KEY_PRESS_LEFT;		break;
+		case 'd': case '6': hit = KEY_PRESS_RIGHT;		break;
+		case 'w': case '8': hit = KEY_PRESS_UP;			break;
+		case 's': case '2': hit = KEY_PRESS_DOWN;		break;
+		case 't':			hit = KEY_PRESS_TAB;		break;
+		case 'f':			m_singleStep = true;		break;
+		case 'r':			m_singleStep = false;		break;
+		case 'q': case 'Q': m_quitRequested = true;		break;
+		default:			hit = key;					break;
 	}
+	if (hit != INVALID_KEY)
+		m_keys.push(hit, now);
+	wakeSimulation();
+	wakeUp();
 }
 
 void GameController::specialKeyboardEvent(int key, int /* x */, int /* y */)
 {
+	KeyQueue::Clock::time_point now = KeyQueue::Clock::now();
+	int hit = INVALID_KEY;
 	switch (key)
 	{
-		case GLUT_KEY_LEFT:	 m_lastKeyHit = KEY_PRESS_LEFT;	 break;
-		case GLUT_KEY_RIGHT: m_lastKeyHit = KEY_PRESS_RIGHT; break;
-		case GLUT_KEY_UP:	 m_lastKeyHit = KEY_PRESS_UP;	 break;
-		case GLUT_KEY_DOWN:	 m_lastKeyHit = KEY_PRESS_DOWN;	 break;
-		default:			 m_lastKeyHit = INVALID_KEY;	 break;
+		case GLUT_KEY_LEFT:	 hit = KEY_PRESS_LEFT;	 break;
+		case GLUT_KEY_RIGHT: hit = KEY_PRESS_RIGHT;	 break;
+		case GLUT_KEY_UP:	 hit = KEY_PRESS_UP;	 break;
+		case GLUT_KEY_DOWN:	 hit = KEY_PRESS_DOWN;	 break;
+		default:			 break;
 	}
+	if (hit != INVALID_KEY)
+		m_keys.push(hit, now);
+	wakeSimulation();
+	wakeUp();
 }
 
 void GameController::playSound(int soundID)
@@ -215,14 +519,23 @@ void GameController::playSound(int soundID)
 		string path = m_gw->assetPath();
 		if (!path.empty())
 			path += '/';
-		SoundFX().playClip(path + p->second);
+		const unsigned char* data;
+		size_t size;
+		if (m_assets.isOpen()  &&  m_assets.findSound(p->second, data, size))
+			SoundFX().playClip(path + p->second, data, size);
+		else
+			SoundFX().playClip(path + p->second);
 	}
 }
 
 void GameController::setGameState(GameControllerState s)
 {
     if (m_gameState != quit)
+	{
         m_gameState = s;
+		if (s == prompt)
+			publishPrompt();
+	}
 }
 void GameController::quitGame()
 {
@@ -255,36 +568,15 @@ void GameController::doSomething()
 			m_nextStateAfterPrompt = cleanup;
 			break;
 		case makemove:
-			m_curIntraFrameTick = ANIMATION_POSITIONS_PER_TICK;
-			m_nextStateAfterAnimate = not_applicable;
-			{
-				int status = m_gw->move();
-				if (status == GWSTATUS_PLAYER_DIED)
-				{
-					  // animate one last frame so the Ego can see what happened
-					m_nextStateAfterAnimate = (m_gw->isGameOver() ? gameover : contgame);
-				}
-				else if (status == GWSTATUS_FINISHED_LEVEL)
-				{
-					m_gw->advanceToNextLevel();
-					  // animate one last frame so the Ego can see what happened
-					m_nextStateAfterAnimate = finishedlevel;
-				}
-			}
-			setGameState(animate);
-			break;
-		case animate:
-			displayGamePlay();
-			if (m_curIntraFrameTick-- <= 0)
+			  // run the ticks the clock says are due (maybe none); each is
+			  // published for the GLUT thread as it finishes
+			runDueTicks();
+			if (m_nextStateAfterAnimate != not_applicable)
 			{
-				if (m_nextStateAfterAnimate != not_applicable)
-					setGameState(m_nextStateAfterAnimate);
-				else
-				{
-					int key;
-					if (!m_singleStep  ||  getLastKey(key))
-						setGameState(makemove);
-				}
+				  // leave the last frame of a life or level up for a tick so
+				  // the Ego can see what happened before the prompt replaces it
+				std::this_thread::sleep_for(std::chrono::milliseconds(std::max(m_ms_per_tick, 1)));
+				setGameState(m_nextStateAfterAnimate);
 			}
 			break;
 		case cleanup:
@@ -303,7 +595,6 @@ void GameController::doSomething()
 			m_nextStateAfterPrompt = quit;
 			break;
 		case prompt:
-			drawPrompt(m_mainMessage, m_secondMessage);
 			{
 				int key;
 				if (getLastKey(key) && key == '\r')
@@ -327,124 +618,181 @@ void GameController::doSomething()
 					m_nextStateAfterPrompt = quit;
 				}
 				else
+				{
+					restartTickClock();
 					setGameState(makemove);
+				}
 			}
 			break;
 		case quit:
             SoundFX().abortClip();
-			glutLeaveMainLoop();
+			m_simulationDone = true;	// the GLUT thread leaves its loop at its next frame
 			break;
 	}
 }
 
 
-void GameController::displayGamePlay()
+void GameController::displayGamePlay(const RenderSnapshot& snapshot)
 {
-	glEnable(GL_DEPTH_TEST); // must be done each time before displaying graphics or gets disabled for some reason
-	glLoadIdentity();
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-#ifdef _MSC_VER
-    gluLookAt(0, 0, 0, 0, 0, -1, 0, 1, 0);
-#else
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
-    gluLookAt(0, 0, 0, 0, 0, -1, 0, 1, 0);
-#pragma GCC diagnostic pop
-#endif
-
-	for (int i = 4 /* NUM_DEPTHS */ - 1; i >= 0; --i)
-	{
-		std::set<GraphObject*> &graphObjects = GraphObject::getGraphObjects(i);
-
-		for (auto it = graphObjects.begin(); it != graphObjects.end(); it++)
-		{
-			GraphObject* cur = *it;
-			if (cur->isVisible())
-			{
-				cur->animate();
+	double tickFraction = tickProgress(snapshot);
 
-				double x, y, gx, gy, gz;
-				cur->getAnimationLocation(x, y);
-				convertToGlutCoords(x, y, gx, gy, gz);
+	beginGameFrame();
 
-				int angle = cur->getDirection();
-				int imageID = cur->getID();
+	for (std::size_t k = 0; k < snapshot.sprites.size(); k++)
+	{
+		const RenderSnapshot::Sprite& cur = snapshot.sprites[k];
+		double x = cur.fromX + (cur.x - cur.fromX) * tickFraction;
+		double y = cur.fromY + (cur.y - cur.fromY) * tickFraction;
+		double gx, gy, gz;
+		convertToGlutCoords(x, y, gx, gy, gz);
 
-				m_spriteManager.plotSprite(imageID, cur->getAnimationNumber() % m_spriteManager.getNumFrames(imageID), gx, gy, gz, angle, cur->getSize());
-			}
-		}
+		m_spriteManager.queueSprite(cur.imageID, cur.animationNumber % m_spriteManager.getNumFrames(cur.imageID), gx, gy, gz, cur.direction, cur.size, cur.depth);
 	}
+	m_spriteManager.drawQueuedSprites();		// the whole frame in a few draw calls
 
-	drawScoreAndLives(m_gameStatText);
+	drawScoreAndLives(m_statusLine, snapshot);
 
 	glutSwapBuffers();
 }
 
 void GameController::reshape (int w, int h)
 {
-	glViewport (0, 0, (GLsizei) w, (GLsizei) h);
-	glMatrixMode (GL_PROJECTION);
-	glLoadIdentity ();
-#ifdef _MSC_VER
-    gluPerspective(45.0, double(WINDOW_WIDTH) / WINDOW_HEIGHT, PERSPECTIVE_NEAR_PLANE, PERSPECTIVE_FAR_PLANE);
-#else
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
-    gluPerspective(45.0, double(WINDOW_WIDTH) / WINDOW_HEIGHT, PERSPECTIVE_NEAR_PLANE, PERSPECTIVE_FAR_PLANE);
-#pragma GCC diagnostic pop
-#endif
-	glMatrixMode (GL_MODELVIEW);
+	setUpGameProjection(w, h);
+	wakeUp();
 }
 
-static void convertToGlutCoords(double x, double y, double& gx, double& gy, double& gz)
+StrokeText::~StrokeText()
 {
-	x /= VIEW_WIDTH;
-	y /= VIEW_HEIGHT;
-	gx = 2 * VISIBLE_MIN_X + .3 + x * 2 * (VISIBLE_MAX_X - VISIBLE_MIN_X);
-	gy = 2 * VISIBLE_MIN_Y +	  y * 2 * (VISIBLE_MAX_Y - VISIBLE_MIN_Y);
-	gz = .6 * VISIBLE_MIN_Z;
+	if (m_list != 0)
+		glDeleteLists(m_list, 1);
 }
 
-static void doOutputStroke(double x, double y, double z, double size, const char* str, bool centered)
+void StrokeText::drawCentered(double y, double z, const std::string& text)
 {
-	if (centered)
+	if (m_list == 0  ||  text != m_text)
 	{
-		double len = glutStrokeLength(GLUT_STROKE_ROMAN, reinterpret_cast<const unsigned char*>(str)) / FONT_SCALEDOWN;
-		x = -len / 2;
-		size = 1;
+		if (m_list == 0)
+			m_list = glGenLists(1);
+		  // glutStrokeCharacter advances the modelview matrix past each
+		  // glyph, and those translations are compiled into the list too
+		glNewList(m_list, GL_COMPILE);
+		for (std::size_t k = 0; k < text.size(); k++)
+			glutStrokeCharacter(GLUT_STROKE_ROMAN, text[k]);
+		glEndList();
+		m_length = glutStrokeLength(GLUT_STROKE_ROMAN, reinterpret_cast<const unsigned char*>(text.c_str())) / FONT_SCALEDOWN;
+		m_text = text;
 	}
-	GLfloat scaledSize = static_cast<GLfloat>(size / FONT_SCALEDOWN);
+
+	GLfloat scaledSize = static_cast<GLfloat>(1 / FONT_SCALEDOWN);
 	glPushMatrix();
 	glLineWidth(1);
 	glLoadIdentity();
-	glTranslatef(static_cast<GLfloat>(x), static_cast<GLfloat>(y), static_cast<GLfloat>(z));
+	glTranslatef(static_cast<GLfloat>(-m_length / 2), static_cast<GLfloat>(y), static_cast<GLfloat>(z));
 	glScalef(scaledSize, scaledSize, scaledSize);
-	for ( ; *str != '\0'; str++)
-		glutStrokeCharacter(GLUT_STROKE_ROMAN, *str);
+	glCallList(m_list);
 	glPopMatrix();
 }
 
-//static void outputStroke(double x, double y, double z, double size, const char* str)
-//{
-//	doOutputStroke(x, y, z, size, str, false);
-//}
+StatusLineText::~StatusLineText()
+{
+	if (m_glyphLists != 0)
+		glDeleteLists(m_glyphLists, NUM_GLYPHS);
+	if (m_labelLists != 0)
+		glDeleteLists(m_labelLists, GameWorld::MAX_STATUS_FIELDS);
+}
+
+void StatusLineText::compileGlyphs()
+{
+	m_glyphLists = glGenLists(NUM_GLYPHS);
+	m_labelLists = glGenLists(GameWorld::MAX_STATUS_FIELDS);
+	for (int c = 0; c < NUM_GLYPHS; c++)
+	{
+		  // each list ends with the glyph's advance, as glutStrokeCharacter
+		  // leaves it, so a string of them lines up as one string would
+		glNewList(m_glyphLists + c, GL_COMPILE);
+		glutStrokeCharacter(GLUT_STROKE_ROMAN, c);
+		glEndList();
+		m_glyphLengths[c] = glutStrokeWidthf(GLUT_STROKE_ROMAN, c);
+	}
+}
+
+void StatusLineText::compileLabel(int k, const char* label)
+{
+	string text = string(label) + ": ";
+	glNewList(m_labelLists + k, GL_COMPILE);
+	for (std::size_t i = 0; i < text.size(); i++)
+		glutStrokeCharacter(GLUT_STROKE_ROMAN, text[i]);
+	glEndList();
+	m_labelLengths[k] = length(text.c_str(), text.size());
+	m_labels[k] = label;
+}
+
+double StatusLineText::length(const char* text, std::size_t size) const
+{
+	double total = 0;
+	for (std::size_t i = 0; i < size; i++)
+		total += m_glyphLengths[static_cast<unsigned char>(text[i]) % NUM_GLYPHS];
+	return total;
+}
 
-static void outputStrokeCentered(double y, double z, const char* str)
+void StatusLineText::drawCentered(double y, double z, const GameWorld::StatusField fields[], int numFields)
 {
-	doOutputStroke(0, y, z, 1, str, true);
+	if (m_glyphLists == 0)
+		compileGlyphs();
+
+	  // each field's number as text, and the whole line's length to centre it
+	static const char SEPARATOR[] = "  ";
+	const int separatorSize = sizeof(SEPARATOR) - 1;
+	char numbers[GameWorld::MAX_STATUS_FIELDS][16];
+	int numberSizes[GameWorld::MAX_STATUS_FIELDS];
+	double lineLength = 0;
+	bool first = true;
+	for (int k = 0; k < numFields; k++)
+	{
+		if (fields[k].label == nullptr)
+			continue;
+		if (fields[k].label != m_labels[k])
+			compileLabel(k, fields[k].label);
+		numberSizes[k] = static_cast<int>(std::to_chars(numbers[k], numbers[k] + sizeof(numbers[k]), fields[k].value).ptr - numbers[k]);
+		if (!first)
+			lineLength += length(SEPARATOR, separatorSize);
+		lineLength += m_labelLengths[k] + length(numbers[k], numberSizes[k]);
+		first = false;
+	}
+
+	GLfloat scaledSize = static_cast<GLfloat>(1 / FONT_SCALEDOWN);
+	glPushMatrix();
+	glLineWidth(1);
+	glLoadIdentity();
+	glTranslatef(static_cast<GLfloat>(-lineLength / FONT_SCALEDOWN / 2), static_cast<GLfloat>(y), static_cast<GLfloat>(z));
+	glScalef(scaledSize, scaledSize, scaledSize);
+	glListBase(m_glyphLists);
+	first = true;
+	for (int k = 0; k < numFields; k++)
+	{
+		if (fields[k].label == nullptr)
+			continue;
+		if (!first)
+			glCallLists(separatorSize, GL_UNSIGNED_BYTE, SEPARATOR);
+		glCallList(m_labelLists + k);
+		glCallLists(numberSizes[k], GL_UNSIGNED_BYTE, numbers[k]);
+		first = false;
+	}
+	glListBase(0);
+	glPopMatrix();
 }
 
-static void drawPrompt(string mainMessage, string secondMessage)
+static void drawPrompt(StrokeText lines[2], const string& mainMessage, const string& secondMessage)
 {
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 	glColor3f (1.0, 1.0, 1.0);
 	glLoadIdentity ();
-	outputStrokeCentered(1, -5, mainMessage.c_str());
-	outputStrokeCentered(-1, -5, secondMessage.c_str());
+	lines[0].drawCentered(1, -5, mainMessage);
+	lines[1].drawCentered(-1, -5, secondMessage);
 	glutSwapBuffers();
 }
 
-static void drawScoreAndLives(string gameStatText)
+static void drawScoreAndLives(StatusLineText& line, const RenderSnapshot& snapshot)
 {
 	static int RATE = 1;
 	static GLfloat rgb[3] =
@@ -459,5 +807,5 @@ static void drawScoreAndLives(string gameStatText)
 		rgb[k] = static_cast<GLfloat>(strength);
 	}
 	glColor3f(rgb[0], rgb[1], rgb[2]);
-	outputStrokeCentered(SCORE_Y, SCORE_Z, gameStatText.c_str());
+	line.drawCentered(SCORE_Y, SCORE_Z, snapshot.status, snapshot.numStatusFields);
 }
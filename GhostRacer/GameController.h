@@ -4,45 +4,212 @@
 #define GAMECONTROLLER_H_
 
 #include "SpriteManager.h"
+#include "WorldController.h"
+#include "InputLog.h"
+#include "GameWorld.h"
+#include "KeyQueue.h"
+#include "TripleBuffer.h"
 #include <string>
 #include <map>
+#include <vector>
 #include <iostream>
 #include <sstream>
+#include <chrono>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
 const int INVALID_KEY = 0;
 
 class GraphObject;
-class GameWorld;
+class Autopilot;
 
-class GameController
+  // A line of stroke-font text, compiled into a display list the first time
+  // it is drawn and only compiled again when the string changes, so text
+  // that stays put from frame to frame costs one glCallList.
+class StrokeText
 {
   public:
-	void run(int argc, char* argv[], GameWorld* gw, std::string windowTitle);
+	StrokeText()
+	 : m_list(0), m_length(0)
+	{
+	}
+
+	~StrokeText();
+
+	void drawCentered(double y, double z, const std::string& text);
 
-	bool getLastKey(int& value)
+  private:
+	std::string	m_text;
+	GLuint		m_list;
+	double		m_length;		// width of m_text in scene units
+
+	StrokeText(const StrokeText&) = delete;
+	StrokeText& operator=(const StrokeText&) = delete;
+};
+
+  // The status line: labelled numbers whose labels hardly ever change but
+  // whose numbers change nearly every frame (Bonus counts down each tick).
+  // Each label (and its ": ") is compiled into a display list of its own
+  // the first time it appears; the numbers and the gaps between fields are
+  // drawn from a display list per glyph, one glCallLists each.  Once the
+  // labels are known, a frame compiles nothing.
+class StatusLineText
+{
+  public:
+	StatusLineText()
+	 : m_glyphLists(0), m_labelLists(0), m_labels(), m_labelLengths()
 	{
-		if (m_lastKeyHit != INVALID_KEY)
+	}
+
+	~StatusLineText();
+
+	  // Draws what GameWorld::formatStatus would make of the fields
+	void drawCentered(double y, double z, const GameWorld::StatusField fields[], int numFields);
+
+  private:
+	static const int NUM_GLYPHS = 128;		// ASCII
+
+	GLuint		m_glyphLists;				// NUM_GLYPHS lists, one per character
+	double		m_glyphLengths[NUM_GLYPHS];	// each character's advance, in font units
+	GLuint		m_labelLists;				// MAX_STATUS_FIELDS lists, one per field's label
+	const char*	m_labels[GameWorld::MAX_STATUS_FIELDS];		// the label each list was compiled from
+	double		m_labelLengths[GameWorld::MAX_STATUS_FIELDS];	// in font units
+
+	void compileGlyphs();
+	void compileLabel(int k, const char* label);
+	double length(const char* text, std::size_t size) const;	// in font units
+
+	StatusLineText(const StatusLineText&) = delete;
+	StatusLineText& operator=(const StatusLineText&) = delete;
+};
+
+  // Decides, frame by frame, whether drawing can be afforded.  It watches
+  // two things.  One is the cost of drawing itself: a running average of
+  // how long recent frames took to draw, which is too much once it is more
+  // than the tick period (the simulation, sharing the CPU, then can't keep
+  // its clock).  The other is the simulation's own clock, which shows the
+  // starving however it came about: the host is behind when the newest
+  // snapshot shows a tick that fell due more than MAX_LAG_TICKS ago (ticks
+  // due since then have not been simulated yet), or when the simulation
+  // has had to run the most catch-up ticks allowed since the last frame.
+  // While either says so, frames are skipped, up to maxSkip in a row.  Only
+  // drawing is ever skipped, so game time stays right.
+class FrameSkipGovernor
+{
+  public:
+	static const int DEFAULT_MAX_SKIP = 4;
+	static constexpr double MAX_LAG_TICKS = 2;	// a snapshot is normally under a tick old
+	static constexpr double DRAW_COST_WEIGHT = 0.125;	// of the newest frame in the average
+
+	FrameSkipGovernor()
+	 : m_maxSkip(DEFAULT_MAX_SKIP), m_skippedInRow(0), m_skipped(0), m_drawn(0), m_drawMs(0)
+	{
+	}
+
+	  // 0 never skips
+	void setMaxSkip(int frames)
+	{
+		m_maxSkip = frames < 0 ? 0 : frames;
+	}
+
+	  // lagTicks is how long ago, in ticks, the tick the newest snapshot
+	  // shows fell due
+	bool shouldDraw(bool caughtUpToLimit, double lagTicks, int msPerTick)
+	{
+		bool behind = caughtUpToLimit  ||  lagTicks > MAX_LAG_TICKS  ||  m_drawMs > msPerTick;
+		if (behind  &&  m_skippedInRow < m_maxSkip)
 		{
-			value = m_lastKeyHit;
-			m_lastKeyHit = INVALID_KEY;
-			return true;
+			m_skippedInRow++;
+			m_skipped++;
+			return false;
 		}
-		return false;
+		m_skippedInRow = 0;
+		m_drawn++;
+		return true;
 	}
 
-	void playSound(int soundID);
+	  // how long the frame shouldDraw last allowed took to draw
+	void recordDrawTime(double ms)
+	{
+		if (m_drawn == 1)
+			m_drawMs = ms;
+		else
+			m_drawMs += DRAW_COST_WEIGHT * (ms - m_drawMs);
+	}
 
-	void setGameStatText(std::string text)
+	double averageDrawMs() const
 	{
-		m_gameStatText = text;
+		return m_drawMs;
 	}
 
-	void doSomething();
+	unsigned long framesSkipped() const
+	{
+		return m_skipped;
+	}
+
+	unsigned long framesDrawn() const
+	{
+		return m_drawn;
+	}
+
+  private:
+	int				m_maxSkip;
+	int				m_skippedInRow;
+	unsigned long	m_skipped;
+	unsigned long	m_drawn;
+	double			m_drawMs;	// running average
+};
+
+  // What the window shows, as of one moment of the simulation: everything
+  // displayGamePlay or drawPrompt needs, copied out of the world so the
+  // GLUT thread can draw it while the simulation thread goes on ticking.
+struct RenderSnapshot
+{
+	enum Screen { BLANK, PLAY, PROMPT };
+
+	struct Sprite
+	{
+		int				imageID;
+		unsigned int	animationNumber;	// the frame drawn is this modulo the image's frame count
+		double			fromX;				// where it was when the tick started...
+		double			fromY;
+		double			x;					// ...and where the tick left it
+		double			y;
+		int				direction;
+		double			size;
+		unsigned int	depth;
+	};
+
+	Screen				screen = BLANK;
+	std::vector<Sprite>	sprites;			// deepest first, the order they are drawn in
+	GameWorld::StatusField	status[GameWorld::MAX_STATUS_FIELDS];	// unformatted; the GLUT thread
+	int					numStatusFields = 0;						// draws the numbers itself
+	std::string			mainMessage;		// for a PROMPT
+	std::string			secondMessage;
+	std::chrono::steady_clock::time_point tickTime;	// when the tick shown fell due
+	int					msPerTick = 0;
+	bool				interpolate = false;	// false draws exactly where the tick left things
+
+	  // running total, for the frame-skip governor
+	unsigned long		catchUpLimitHits = 0;
+};
+
+class GameController : public WorldController
+{
+  public:
+	void run(int argc, char* argv[], GameWorld* gw, std::string windowTitle);
+
+	virtual bool getLastKey(int& value);
 
+	virtual void playSound(int soundID);
+
+	void displayEvent();
 	void reshape(int w, int h);
 	void keyboardEvent(unsigned char key, int x, int y);
 	void specialKeyboardEvent(int key, int x, int y);
 
-    void quitGame();
+    virtual void quitGame();
 
 	  // Meyers singleton pattern
 	static GameController& getInstance()
@@ -51,34 +218,103 @@ class GameController
 		return instance;
 	}
 
-	static void timerFuncCallback(int nothing);
-	void setMsPerTick(int ms_per_tick) { m_ms_per_tick = ms_per_tick;  }
+	  // Record the game run() plays (its seed and every key the world is
+	  // handed) to path when it ends, for GhostRacerHeadless --replay.
+	void setRecordPath(std::string path)
+	{
+		m_recordPath = path;
+	}
+
+	  // Let autopilot drive the game run() plays, choosing each tick's key
+	  // in place of the keyboard.  The controller does not own autopilot.
+	void setAutopilot(Autopilot* autopilot)
+	{
+		m_autopilot = autopilot;
+	}
+
+	  // Most frames in a row the game may leave undrawn when the host can't
+	  // keep up (see FrameSkipGovernor); 0 draws every frame.
+	void setMaxFrameSkip(int frames)
+	{
+		m_governor.setMaxSkip(frames);
+	}
+
+	static void timerFuncCallback(int generation);
+	virtual void setMsPerTick(int ms_per_tick) { m_ms_per_tick = ms_per_tick;  }
 
 private:
     enum GameControllerState : int;
 
+	  // The game runs on two threads.  The simulation thread (simulate())
+	  // owns the world and the game state machine: it ticks, plays sounds,
+	  // takes keys off m_keys and publishes a RenderSnapshot into
+	  // m_snapshots after every batch of ticks and for every prompt.  The GLUT thread
+	  // only handles window events and draws the newest snapshot.  Neither
+	  // waits for the other; the only things they share are the lock-free
+	  // key queue, the triple buffer and the atomic flags below.
+
+	  // simulation thread
 	GameWorld*	m_gw;
 	GameControllerState	m_gameState;
 	GameControllerState	m_nextStateAfterPrompt;
 	GameControllerState	m_nextStateAfterAnimate;
-	int			m_lastKeyHit;
-	bool		m_singleStep;
-	std::string m_gameStatText;
+	KeyQueue::Clock::time_point	m_keyDeadline;	// when the tick being simulated is due; later presses wait
 	std::string m_mainMessage;
 	std::string m_secondMessage;
-	int			m_curIntraFrameTick;
+	std::chrono::steady_clock::time_point m_lastTickTime;
+	std::chrono::steady_clock::duration	m_tickLag;	// real time not yet simulated
+	unsigned long	m_catchUpLimitHits;
 	using SoundMapType = std::map<int, std::string>;
 	using DrawMapType  = std::map<int, std::string>;
 	SoundMapType m_soundMap;
 	bool		m_playerWon;
+	InputLog	m_inputLog;
+	Autopilot*	m_autopilot;
+	int			m_autopilotKey;		// what the autopilot chose for this tick
+
+	  // shared
+	KeyQueue	m_keys;				// presses from the keyboard callbacks, oldest first
+	TripleBuffer<RenderSnapshot>	m_snapshots;
+	std::atomic<bool>	m_singleStep;
+	std::atomic<bool>	m_quitRequested;	// 'q' or the window closing
+	std::atomic<bool>	m_simulationDone;
+	std::mutex			m_wakeMutex;		// only to wait on m_wakeCondition
+	std::condition_variable	m_wakeCondition;	// a key was pressed or quitting was asked for
+	std::thread			m_simulationThread;
+	AssetBundle			m_assets;			// opened before the thread starts, only read after
+
+	  // GLUT thread
+	StatusLineText	m_statusLine;
+	StrokeText	m_promptLines[2];
+	bool		m_promptNeedsDrawing;	// the prompt on screen is stale (new, exposed or resized)
+	int			m_timerGeneration;		// timers scheduled before the last wakeUp() are ignored
+	int			m_timerMs;				// delay before the next timer; grows while idle at a prompt
+	FrameSkipGovernor	m_governor;
+	unsigned long	m_governorCatchUpLimitHits;	// the snapshot total the governor has been told about
 	SpriteManager m_spriteManager;
+	std::string	m_recordPath;
 
     void setGameState(GameControllerState s);
 
 	void initDrawersAndSounds();
-	void displayGamePlay();
+	void simulate();
+	void doSomething();
+	void waitForWork();
+	void publishPlay();
+	void publishPrompt();
+	void render();
+	void displayGamePlay(const RenderSnapshot& snapshot);
+	int nextTimerDelay();
+	void wakeUp();
+	void wakeSimulation();
+	void restartTickClock();
+	int ticksDue();
+	int runDueTicks();
+	double tickProgress(const RenderSnapshot& snapshot) const;
 
-	static const int kDefaultMsPerTick = 10;
+	  // the rate the old 5 ms timer managed (a tick every third timer) when
+	  // nothing else was running
+	static const int kDefaultMsPerTick = 15;
 	static int m_ms_per_tick;
 };
 
@@ -0,0 +1,66 @@
+#ifndef GAMEVIEW_H_
+#define GAMEVIEW_H_
+
+#include "freeglut.h"
+#include "GameConstants.h"
+
+  // Where the game's world sits in front of the camera, shared by
+  // everything that draws it (GameController, and GhostRacerRenderCheck,
+  // which must draw exactly the frames the game does).
+
+const int WINDOW_WIDTH = 768; //1024;
+const int WINDOW_HEIGHT = 768;
+
+const int PERSPECTIVE_NEAR_PLANE = 4;
+const int PERSPECTIVE_FAR_PLANE	= 22;
+
+const double VISIBLE_MIN_X = -2.39;
+const double VISIBLE_MAX_X = 2.1; // 2.39;
+const double VISIBLE_MIN_Y = -2.1;
+const double VISIBLE_MAX_Y = 1.9;
+const double VISIBLE_MIN_Z = -20;
+// const double VISIBLE_MAX_Z = -6;
+
+  // The projection for a w x h window
+inline void setUpGameProjection(int w, int h)
+{
+	glViewport (0, 0, (GLsizei) w, (GLsizei) h);
+	glMatrixMode (GL_PROJECTION);
+	glLoadIdentity ();
+#ifdef _MSC_VER
+    gluPerspective(45.0, double(WINDOW_WIDTH) / WINDOW_HEIGHT, PERSPECTIVE_NEAR_PLANE, PERSPECTIVE_FAR_PLANE);
+#else
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+    gluPerspective(45.0, double(WINDOW_WIDTH) / WINDOW_HEIGHT, PERSPECTIVE_NEAR_PLANE, PERSPECTIVE_FAR_PLANE);
+#pragma GCC diagnostic pop
+#endif
+	glMatrixMode (GL_MODELVIEW);
+}
+
+  // Clears the frame and points the camera at the world, ready for sprites
+inline void beginGameFrame()
+{
+	glEnable(GL_DEPTH_TEST); // must be done each time before displaying graphics or gets disabled for some reason
+	glLoadIdentity();
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+#ifdef _MSC_VER
+    gluLookAt(0, 0, 0, 0, 0, -1, 0, 1, 0);
+#else
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+    gluLookAt(0, 0, 0, 0, 0, -1, 0, 1, 0);
+#pragma GCC diagnostic pop
+#endif
+}
+
+inline void convertToGlutCoords(double x, double y, double& gx, double& gy, double& gz)
+{
+	x /= VIEW_WIDTH;
+	y /= VIEW_HEIGHT;
+	gx = 2 * VISIBLE_MIN_X + .3 + x * 2 * (VISIBLE_MAX_X - VISIBLE_MIN_X);
+	gy = 2 * VISIBLE_MIN_Y +	  y * 2 * (VISIBLE_MAX_Y - VISIBLE_MIN_Y);
+	gz = .6 * VISIBLE_MIN_Z;
+}
+
+#endif // GAMEVIEW_H_
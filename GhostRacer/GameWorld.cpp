@@ -1,7 +1,9 @@
 // This file written by Professors Carey Nachenberg and David Smallberg for CS32 Student use in Project 3.  
 
 #include "GameWorld.h"
-#include "GameController.h"
+#include "WorldController.h"
+#include "InputLog.h"
+#include "StateStream.h"
 #include <string>
 #include <cstdlib>
 using namespace std;
@@ -12,6 +14,8 @@ bool GameWorld::getKey(int& value)
 
 	if (gotKey)
 	{
+		if (m_inputLog != nullptr)
+			m_inputLog->recordKey(m_tick, value);
 		if (value == 'q'  ||  value == '\x03')  // CTRL-C
 			m_controller->quitGame();
 	}
@@ -23,12 +27,110 @@ void GameWorld::playSound(int soundID)
 	m_controller->playSound(soundID);
 }
 
-void GameWorld::setGameStatText(string text)
+string GameWorld::formatStatus(const StatusField fields[], int numFields)
 {
-	m_controller->setGameStatText(text);
+	string text;
+	for (int k = 0; k < numFields; k++)
+	{
+		const StatusField& field = fields[k];
+		if (field.label == nullptr)
+			continue;
+		if (!text.empty())
+			text += "  ";
+		text += field.label;
+		text += ": ";
+		text += to_string(field.value);
+	}
+	return text;
 }
 
 void GameWorld::setMsPerTick(int ms_per_tick)
 {
 	m_controller->setMsPerTick(ms_per_tick);
 }
+
+int GameWorld::step()
+{
+	int status = move();
+	if (status == GWSTATUS_PLAYER_DIED  &&  m_inputLog != nullptr)
+		m_inputLog->recordDeath(m_tick);
+	m_tick++;
+	return status;
+}
+
+void GameWorld::startRecording(InputLog* log)
+{
+	m_inputLog = log;
+	m_inputLog->start(m_seed);
+}
+
+void GameWorld::stopRecording()
+{
+	if (m_inputLog == nullptr)
+		return;
+	InputLog::Outcome outcome;
+	outcome.ticks = m_tick;
+	outcome.score = getScore();
+	outcome.level = getLevel();
+	outcome.lives = getLives();
+	outcome.gameOver = isGameOver();
+	m_inputLog->finish(outcome);
+	m_inputLog = nullptr;
+}
+
+static const std::uint32_t STATE_MAGIC = 0x53575247;	// "GRWS"
+
+void GameWorld::saveState(StateWriter& out) const
+{
+	out.put(STATE_MAGIC);
+	out.put(m_lives);
+	out.put(m_score);
+	out.put(m_level);
+	out.put(m_tick);
+	out.put(m_seed);
+	std::uint64_t random[RandomGenerator::STATE_WORDS];
+	m_random.getState(random);
+	out.put(random);
+	saveWorld(out);
+}
+
+bool GameWorld::restoreState(StateReader& in)
+{
+	std::uint32_t magic = 0;
+	int lives, score, level;
+	long tick;
+	std::uint64_t seed;
+	std::uint64_t random[RandomGenerator::STATE_WORDS];
+	in.get(magic);
+	if (magic != STATE_MAGIC)
+		return false;
+	in.get(lives);
+	in.get(score);
+	in.get(level);
+	in.get(tick);
+	in.get(seed);
+	in.get(random);
+	if (in.failed())
+		return false;
+
+	  // The world rebuilds itself first: making its actors may draw from the
+	  // generator, which is only put back afterwards.
+	if (!restoreWorld(in))
+		return false;
+
+	m_lives = lives;
+	m_score = score;
+	m_level = level;
+	m_tick = tick;
+	m_seed = seed;
+	m_random.setState(random);
+	return true;
+}
+
+bool GameWorld::cloneInto(GameWorld* dest) const
+{
+	m_cloneBuffer.clear();
+	saveState(m_cloneBuffer);
+	StateReader in(m_cloneBuffer.data(), m_cloneBuffer.size());
+	return dest->restoreState(in);
+}
@@ -4,11 +4,17 @@
 #define GAMEWORLD_H_
 
 #include "GameConstants.h"
+#include "GraphObject.h"
+#include "RandomGenerator.h"
+#include "StateStream.h"
 #include <string>
+#include <random>
+#include <cstdint>
 
 const int START_PLAYER_LIVES = 3;
 
-class GameController;
+class WorldController;
+class InputLog;
 
 class GameWorld
 {
@@ -16,7 +22,10 @@ public:
 
 	GameWorld(std::string assetPath)
 	 : m_lives(START_PLAYER_LIVES), m_score(0), m_level(1),
-	   m_controller(nullptr), m_assetPath(assetPath)
+	   m_controller(nullptr), m_assetPath(assetPath),
+	   m_tick(0), m_inputLog(nullptr),
+	   m_seed(std::random_device{}()), m_random(m_seed),
+	   m_statusFields(), m_numStatusFields(0)
 	{
 	}
 
@@ -28,11 +37,59 @@ public:
 	virtual int move() = 0;
 	virtual void cleanUp() = 0;
 
-	void setGameStatText(std::string text);
+	  // One tick of play: move() plus the framework's bookkeeping (the tick
+	  // count and any input recording).  Controllers call this, not move().
+	int step();
+
+	  // The status line shown above the play field, kept as labelled
+	  // counters rather than text.  A world sets its fields every tick, which
+	  // costs a store or two each.  Whatever displays the line copies the
+	  // fields out and turns them into text itself, only when it draws;
+	  // headless runs never format it at all.  label must be a string literal
+	  // (it is kept, not copied).
+	static const int MAX_STATUS_FIELDS = 8;
+
+	struct StatusField
+	{
+		const char*	label;		// nullptr for a field never set
+		int			value;
+	};
+
+	void setStatusField(int index, const char* label, int value)
+	{
+		if (index < 0  ||  index >= MAX_STATUS_FIELDS)
+			return;
+		StatusField& field = m_statusFields[index];
+		field.label = label;
+		field.value = value;
+		if (index >= m_numStatusFields)
+			m_numStatusFields = index + 1;
+	}
+
+	  // The fields set so far, numStatusFields() of them
+	const StatusField* statusFields() const
+	{
+		return m_statusFields;
+	}
+
+	int numStatusFields() const
+	{
+		return m_numStatusFields;
+	}
+
+	  // "Label: value  Label: value ..." for the numFields fields
+	static std::string formatStatus(const StatusField fields[], int numFields);
 
 	bool getKey(int& value);
 	void playSound(int soundID);
 
+	  // Uniformly distributed random int from min to max, inclusive, drawn
+	  // from this world's own generator
+	int randInt(int min, int max)
+	{
+		return m_random.randInt(min, max);
+	}
+
 	int getLevel() const
 	{
 		return m_level;
@@ -75,7 +132,7 @@ public:
 		++m_level;
 	}
  
-	void setController(GameController* controller)
+	void setController(WorldController* controller)
 	{
 		m_controller = controller;
 	}
@@ -86,12 +143,75 @@ public:
 	}
 
 	void setMsPerTick(int ms_per_tick);
+
+	  // Restart this world's random sequence, e.g. so a game can be replayed
+	  // exactly.  Without it every world starts from a nondeterministic seed.
+	void seedRandom(std::uint64_t seed)
+	{
+		m_seed = seed;
+		m_random.seed(seed);
+	}
+
+	std::uint64_t getSeed() const
+	{
+		return m_seed;
+	}
+
+	  // Number of step() calls so far
+	long getTick() const
+	{
+		return m_tick;
+	}
+
+	  // Log the seed and every key handed to the world into log, until
+	  // stopRecording() writes the final result into it.  The world does not
+	  // own log.  Start before the first step() so the seed still describes
+	  // the whole game.
+	void startRecording(InputLog* log);
+	void stopRecording();
+
+	  // Binary save state of the whole world: lives, score, level, tick
+	  // count and random generator here, the rest through saveWorld/
+	  // restoreWorld.  Restoring returns false if the data is not a save
+	  // state this build wrote.  A bad or truncated header leaves the world
+	  // untouched; bad data after it leaves the world with no level running.
+	void saveState(StateWriter& out) const;
+	bool restoreState(StateReader& in);
+
+	  // Makes dest, a world of the same kind (e.g. from the same factory),
+	  // an exact copy of this one: same level, actors, tick count and random
+	  // generator, so both go on identically given the same keys.  dest
+	  // keeps its own controller, display registry and recording, so a copy
+	  // can be simulated ahead without drawing, sounding or logging
+	  // anything.  Goes through a save state kept in a buffer that is
+	  // reused from one clone to the next.
+	bool cloneInto(GameWorld* dest) const;
+
+	  // Everything this world displays.  The world makes it current while
+	  // it creates GraphObjects; the framework draws from it.
+	GraphObjectRegistry& graphObjects()
+	{
+		return m_graphObjects;
+	}
 private:
+	  // The world's own part of a save state.  Worlds that don't override
+	  // these save nothing beyond what GameWorld keeps.
+	virtual void saveWorld(StateWriter& /* out */) const {}
+	virtual bool restoreWorld(StateReader& /* in */) { return true; }
+
 	int				m_lives;
 	int				m_score;
 	int				m_level;
-	GameController* m_controller;
+	WorldController* m_controller;
 	std::string		m_assetPath;
+	GraphObjectRegistry m_graphObjects;
+	long			m_tick;
+	InputLog*		m_inputLog;
+	std::uint64_t	m_seed;
+	RandomGenerator	m_random;
+	mutable StateWriter m_cloneBuffer;
+	StatusField		m_statusFields[MAX_STATUS_FIELDS];
+	int				m_numStatusFields;
 };
 
 #endif // GAMEWORLD_H_
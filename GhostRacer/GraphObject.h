@@ -3,13 +3,118 @@
 #ifndef GRAPHOBJ_H_
 #define GRAPHOBJ_H_
 
-#include "SpriteManager.h"
 #include "GameConstants.h"
+#include "TrigTable.h"
 
-#include <set>
+#include <vector>
+#include <cstddef>
 #include <cmath>
 
-const int ANIMATION_POSITIONS_PER_TICK = 1;
+class GraphObject;
+
+  // The GraphObjects one world displays, by depth.  Every GameWorld owns
+  // one, so worlds running side by side on different threads never share
+  // display state.  A GraphObject joins whichever registry is current on
+  // its thread when it is constructed; a world makes its own registry
+  // current (with a Scope) while it builds objects.
+  //
+  // Each depth is a plain array of pointers, and each object remembers its
+  // own slot, so joining is a push_back and leaving moves the last object
+  // of that depth into the hole.  Draw order is the order of the array,
+  // which depends only on the order objects came and went in, never on
+  // where they happen to be in memory.  The arrays keep their capacity, so
+  // once a world has warmed up, spawning and destroying objects (and
+  // whole levels) allocates nothing here.
+class GraphObjectRegistry
+{
+  public:
+	static const int NUM_DEPTHS = 4;
+
+	GraphObjectRegistry()
+	 : m_tracking(true)
+	{
+	}
+
+	~GraphObjectRegistry()
+	{
+		clear();
+	}
+
+	const std::vector<GraphObject*>& getGraphObjects(unsigned int layer) const
+	{
+		return m_graphObjects[layerFor(layer)];
+	}
+
+	void add(GraphObject* object, unsigned int layer);
+	void remove(GraphObject* object, unsigned int layer);
+
+	  // A registry that isn't tracking lists nothing, so objects made while
+	  // it is current are never drawn and cost nothing to register.  For
+	  // worlds that are only ever simulated, such as lookahead copies; set
+	  // it before the world makes any objects.
+	void setTracking(bool tracking)
+	{
+		m_tracking = tracking;
+	}
+
+	  // Drop every registration at once, e.g. when a whole level is torn
+	  // down.  Objects destroyed afterwards skip their own removal.
+	void clear();
+
+	  // Called just before the world ticks: where every object is now
+	  // becomes where its drawing will glide from during the tick.
+	void settleAnimations();
+
+	  // The registry new GraphObjects on this thread join.  Threads that
+	  // never install one get a registry of their own.
+	static GraphObjectRegistry& current()
+	{
+		thread_local GraphObjectRegistry threadDefault;
+		GraphObjectRegistry* installed = installedRegistry();
+		return installed != nullptr ? *installed : threadDefault;
+	}
+
+	  // Makes a registry current on this thread for the life of the Scope.
+	class Scope
+	{
+	  public:
+		Scope(GraphObjectRegistry& registry)
+		 : m_previous(installedRegistry())
+		{
+			installedRegistry() = &registry;
+		}
+
+		~Scope()
+		{
+			installedRegistry() = m_previous;
+		}
+
+	  private:
+		GraphObjectRegistry* m_previous;
+
+		Scope(const Scope&);
+		Scope& operator=(const Scope&);
+	};
+
+  private:
+	std::vector<GraphObject*> m_graphObjects[NUM_DEPTHS];
+	bool				m_tracking;
+
+	static unsigned int layerFor(unsigned int layer)
+	{
+		return layer < NUM_DEPTHS ? layer : 0;
+	}
+
+	static GraphObjectRegistry*& installedRegistry()
+	{
+		thread_local GraphObjectRegistry* installed = nullptr;
+		return installed;
+	}
+
+	  // Prevent copying or assigning registries
+	GraphObjectRegistry(const GraphObjectRegistry&);
+	GraphObjectRegistry& operator=(const GraphObjectRegistry&);
+};
 
 class GraphObject
 {
@@ -21,20 +126,22 @@ class GraphObject
 	static const int down = 270;
 
 	GraphObject(int imageID, double startX, double startY, int dir = 0, double size = 1.0, unsigned int depth = 0)
-	 : m_imageID(imageID), m_visible(true), m_x(startX), m_y(startY),
+	 : m_imageID(imageID), m_visible(true), m_registry(&GraphObjectRegistry::current()), m_registryIndex(0),
+	   m_x(startX), m_y(startY),
 	   m_destX(startX), m_destY(startY), m_brightness(1.0),
 	   m_animationNumber(0), m_direction(dir), m_size(size), m_depth(depth)
 	{
 		if (m_size <= 0)
 			m_size = 1;
 
-		getGraphObjects(m_depth).insert(this);
+		m_registry->add(this, m_depth);		// sets m_registryIndex, or clears m_registry if it isn't tracking
 		setVisible(true);
 	}
 
 	virtual ~GraphObject()
 	{
-		getGraphObjects(m_depth).erase(this);
+		if (m_registry != nullptr)
+			m_registry->remove(this, m_depth);
 	}
 
 	void setVisible(bool shouldIDisplay)
@@ -77,9 +184,8 @@ class GraphObject
 
 	virtual void getPositionInThisDirection(int angle, int units, double &dx, double &dy)
 	{
-		static const double PI = 4 * atan(1.0);
-		dx = (getX() + units * cos(angle*1.0 / 360 * 2 * PI));
-		dy = (getY() + units * sin(angle*1.0 / 360 * 2 * PI));
+		dx = (getX() + units * TrigTable::cosDegrees(angle));
+		dy = (getY() + units * TrigTable::sinDegrees(angle));
 	}
 
 	void moveForward(int units = 1)
@@ -134,27 +240,22 @@ class GraphObject
 		return m_animationNumber;
 	}
 
-	void getAnimationLocation(double& x, double& y) const
+	  // Where to draw the object tickFraction of the way through the tick
+	  // after the last one simulated: between where it was when that tick
+	  // started and where the tick left it.  Frames drawn between ticks
+	  // then show smooth motion instead of a jump per tick, at the price of
+	  // showing the world up to one tick late.
+	void getAnimationLocation(double& x, double& y, double tickFraction = 1) const
 	{
-		x = m_x;
-		y = m_y;
+		x = m_x + (m_destX - m_x) * tickFraction;
+		y = m_y + (m_destY - m_y) * tickFraction;
 	}
 
+	  // Snap to the simulated position; the next tick's motion starts here.
 	void animate()
 	{
 		m_x = m_destX;
 		m_y = m_destY;
-//		moveALittle(m_x, m_destX);
-	//	moveALittle(m_y, m_destY);
-	}
-
-	static std::set<GraphObject*>& getGraphObjects(unsigned int layer)
-	{
-		static std::set<GraphObject*> graphObjects[NUM_DEPTHS];
-		if (layer < NUM_DEPTHS)
-			return graphObjects[layer];
-		else
-			return graphObjects[0];		// empty;
 	}
 
 	void increaseAnimationNumber()
@@ -162,22 +263,31 @@ class GraphObject
 		m_animationNumber++;
 	}
 
+	  // Puts back the animation frame saved with a world's state.
+	void setAnimationNumber(unsigned int number)
+	{
+		m_animationNumber = number;
+	}
 
-private:
-	friend class GameController;
 	unsigned int getID() const
 	{
 		return m_imageID;
 	}
 
+
+private:
+	friend class GameController;
+	friend class GraphObjectRegistry;
+
   private:
 	  // Prevent copying or assigning GraphObjects
 	GraphObject(const GraphObject&);
 	GraphObject& operator=(const GraphObject&);
 
-	static const int NUM_DEPTHS = 4;
 	int		m_imageID;
 	bool	m_visible;
+	GraphObjectRegistry* m_registry;	// registry this object is listed in, null once it has been cleared
+	std::size_t	m_registryIndex;		// where in its depth's array
 	double	m_x;
 	double	m_y;
 	double	m_destX;
@@ -187,19 +297,49 @@ private:
 	int	m_direction;
 	double	m_size;
 	int		m_depth;
+};
 
-	void moveALittle(double& from, double& to)
+inline void GraphObjectRegistry::add(GraphObject* object, unsigned int layer)
+{
+	if (!m_tracking)
 	{
-		static const double DISTANCE = 1.0/ANIMATION_POSITIONS_PER_TICK;
-		if (to - from >= DISTANCE)
-			from += DISTANCE;
-		else if (from - to >= DISTANCE)
-			from -= DISTANCE;
-		else
-			from = to;
+		object->m_registry = nullptr;
+		return;
 	}
+	std::vector<GraphObject*>& objects = m_graphObjects[layerFor(layer)];
+	object->m_registryIndex = objects.size();
+	objects.push_back(object);
+}
 
+inline void GraphObjectRegistry::remove(GraphObject* object, unsigned int layer)
+{
+	std::vector<GraphObject*>& objects = m_graphObjects[layerFor(layer)];
+	std::size_t index = object->m_registryIndex;
+	GraphObject* last = objects.back();
+	objects[index] = last;
+	last->m_registryIndex = index;
+	objects.pop_back();
+}
+
+inline void GraphObjectRegistry::settleAnimations()
+{
+	for (unsigned int layer = 0; layer < NUM_DEPTHS; layer++)
+	{
+		std::vector<GraphObject*>& objects = m_graphObjects[layer];
+		for (std::size_t k = 0; k < objects.size(); k++)
+			objects[k]->animate();
+	}
+}
 
-};
+inline void GraphObjectRegistry::clear()
+{
+	for (unsigned int layer = 0; layer < NUM_DEPTHS; layer++)
+	{
+		std::vector<GraphObject*>& objects = m_graphObjects[layer];
+		for (std::size_t k = 0; k < objects.size(); k++)
+			objects[k]->m_registry = nullptr;
+		objects.clear();
+	}
+}
 
 #endif // GRAPHOBJ_H_
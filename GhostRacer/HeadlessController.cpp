@@ -0,0 +1,142 @@
+#include "HeadlessController.h"
+#include "GameWorld.h"
+#include "GameConstants.h"
+#include "InputLog.h"
+#include "Autopilot.h"
+#include <string>
+#include <vector>
+#include <chrono>
+using namespace std;
+
+static const int NO_KEY = 0;
+
+HeadlessController::HeadlessController(string keyScript)
+ : m_keyScript(keyScript), m_replay(nullptr), m_nextReplayKey(0), m_autopilot(nullptr), m_autopilotKey(NO_KEY),
+   m_tick(0), m_quit(false)
+{
+}
+
+HeadlessController::HeadlessController(const InputLog& replay)
+ : m_replay(&replay), m_nextReplayKey(0), m_autopilot(nullptr), m_autopilotKey(NO_KEY), m_tick(0), m_quit(false)
+{
+}
+
+int HeadlessController::translateScriptKey(char c)
+{
+	switch (c)
+	{
+		case 'a': case '4': return KEY_PRESS_LEFT;
+		case 'd': case '6': return KEY_PRESS_RIGHT;
+		case 'w': case '8': return KEY_PRESS_UP;
+		case 's': case '2': return KEY_PRESS_DOWN;
+		case ' ':			return KEY_PRESS_SPACE;
+		case 'q':			return 'q';
+		default:			return NO_KEY;
+	}
+}
+
+bool HeadlessController::getLastKey(int& value)
+{
+	if (m_autopilot != nullptr)
+	{
+		if (m_autopilotKey == NO_KEY)
+			return false;
+		value = m_autopilotKey;
+		m_autopilotKey = NO_KEY;
+		return true;
+	}
+
+	if (m_replay != nullptr)
+	{
+		const vector<InputLog::KeyEvent>& keys = m_replay->keys();
+		  // a replay that has diverged may skip ticks the recording asked on
+		while (m_nextReplayKey < keys.size()  &&  keys[m_nextReplayKey].tick < m_tick)
+			m_nextReplayKey++;
+		if (m_nextReplayKey == keys.size()  ||  keys[m_nextReplayKey].tick != m_tick)
+			return false;
+		value = keys[m_nextReplayKey++].key;
+		return true;
+	}
+
+	if (m_keyScript.empty())
+		return false;
+
+	int key = translateScriptKey(m_keyScript[m_tick % m_keyScript.size()]);
+	if (key == NO_KEY)
+		return false;
+	value = key;
+	return true;
+}
+
+HeadlessController::RunStats HeadlessController::run(GameWorld* gw, long maxTicks)
+{
+	m_tick = 0;
+	return play(gw, maxTicks, true);
+}
+
+HeadlessController::RunStats HeadlessController::resume(GameWorld* gw, long untilTick, bool needInit)
+{
+	m_tick = gw->getTick();
+	return play(gw, untilTick, needInit);
+}
+
+HeadlessController::RunStats HeadlessController::play(GameWorld* gw, long untilTick, bool needInit)
+{
+	gw->setController(this);
+	m_nextReplayKey = 0;
+	m_quit = false;
+
+	long startTick = m_tick;
+	bool gameOver = false;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+	while (m_tick < untilTick  &&  !m_quit)
+	{
+		if (needInit)
+		{
+			int status = gw->init();
+			if (status == GWSTATUS_PLAYER_WON  ||  status == GWSTATUS_LEVEL_ERROR)
+			{
+				gameOver = true;
+				break;
+			}
+			needInit = false;
+		}
+
+		if (m_autopilot != nullptr)
+			m_autopilotKey = m_autopilot->chooseKey(*gw);
+		int status = gw->step();
+		m_tick++;
+
+		if (status == GWSTATUS_PLAYER_DIED)
+		{
+			if (gw->isGameOver())
+			{
+				gameOver = true;
+				break;
+			}
+			gw->cleanUp();
+			needInit = true;
+		}
+		else if (status == GWSTATUS_FINISHED_LEVEL)
+		{
+			gw->advanceToNextLevel();
+			gw->cleanUp();
+			needInit = true;
+		}
+
+		if (m_tickCallback)
+			m_tickCallback(*gw, needInit);
+	}
+
+	chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+	RunStats stats;
+	stats.ticks = m_tick - startTick;
+	stats.seconds = elapsed.count();
+	stats.score = gw->getScore();
+	stats.level = gw->getLevel();
+	stats.lives = gw->getLives();
+	stats.gameOver = gameOver;
+	return stats;
+}
@@ -0,0 +1,92 @@
+#ifndef HEADLESSCONTROLLER_H_
+#define HEADLESSCONTROLLER_H_
+
+#include "WorldController.h"
+#include <string>
+#include <functional>
+#include <cstddef>
+
+class GameWorld;
+class InputLog;
+class Autopilot;
+
+  // Drives a GameWorld through init()/move()/cleanUp() with no window, no
+  // timer and no sound.  Keys come from a script: one character per tick,
+  // using the same letters as the keyboard ('a' left, 'd' right, 'w' up,
+  // 's' down, ' ' fire) and '.' for "no key this tick".  The script repeats
+  // when it runs out.  Alternatively the keys come from an InputLog, each
+  // handed over on the tick it was recorded on, to replay a recorded game,
+  // or from an Autopilot that decides each tick's key by searching ahead.
+
+class HeadlessController : public WorldController
+{
+  public:
+	struct RunStats
+	{
+		long	ticks;
+		double	seconds;
+		int		score;
+		int		level;
+		int		lives;
+		bool	gameOver;
+
+		double ticksPerSecond() const
+		{
+			return seconds > 0 ? ticks / seconds : 0;
+		}
+	};
+
+	HeadlessController(std::string keyScript = "");
+
+	  // Replays replay's keys; the caller keeps replay alive and seeds the
+	  // world with replay.seed().  The controller does not own replay.
+	explicit HeadlessController(const InputLog& replay);
+
+	  // Plays a fresh world until the game is over, the script asks to quit,
+	  // or maxTicks calls to step() have been made.  The controller does not
+	  // own gw.
+	RunStats run(GameWorld* gw, long maxTicks);
+
+	  // Carries on with a world restored from a save state until it has
+	  // made untilTick steps in all (GameWorld::getTick), the game is over
+	  // or the keys quit.  needInit says the restored world is between
+	  // levels, so its next tick starts with init().
+	RunStats resume(GameWorld* gw, long untilTick, bool needInit);
+
+	  // Called after every tick the game goes on from, with whether the
+	  // next tick starts a new level.  The world is at a tick boundary, so
+	  // this is where save states can be taken.
+	using TickCallback = std::function<void(GameWorld& gw, bool needInit)>;
+	void setTickCallback(TickCallback callback)
+	{
+		m_tickCallback = callback;
+	}
+
+	  // Lets autopilot choose every key instead of the script.  The
+	  // controller does not own autopilot; nullptr goes back to the script.
+	void setAutopilot(Autopilot* autopilot)
+	{
+		m_autopilot = autopilot;
+	}
+
+	virtual bool getLastKey(int& value);
+	virtual void playSound(int /* soundID */) {}
+	virtual void quitGame() { m_quit = true; }
+	virtual void setMsPerTick(int /* ms_per_tick */) {}
+
+	static int translateScriptKey(char c);
+
+  private:
+	std::string	m_keyScript;
+	const InputLog* m_replay;
+	std::size_t	m_nextReplayKey;
+	Autopilot*	m_autopilot;
+	int			m_autopilotKey;		// what the autopilot chose for this tick
+	long		m_tick;
+	bool		m_quit;
+	TickCallback m_tickCallback;
+
+	RunStats play(GameWorld* gw, long untilTick, bool needInit);
+};
+
+#endif // HEADLESSCONTROLLER_H_
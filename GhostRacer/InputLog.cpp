@@ -0,0 +1,156 @@
+#include "InputLog.h"
+#include <fstream>
+#include <sstream>
+#include <string>
+using namespace std;
+
+static const char* const LOG_MAGIC = "GRLOG";
+static const int LOG_VERSION = 1;
+
+InputLog::InputLog()
+ : m_seed(0), m_finished(false)
+{
+	m_outcome = Outcome();
+}
+
+void InputLog::start(uint64_t seed)
+{
+	m_seed = seed;
+	m_keys.clear();
+	m_deaths.clear();
+	m_outcome = Outcome();
+	m_finished = false;
+}
+
+void InputLog::recordKey(long tick, int key)
+{
+	KeyEvent e;
+	e.tick = tick;
+	e.key = key;
+	m_keys.push_back(e);
+}
+
+void InputLog::recordDeath(long tick)
+{
+	m_deaths.push_back(tick);
+}
+
+void InputLog::finish(const Outcome& outcome)
+{
+	m_outcome = outcome;
+	m_finished = true;
+}
+
+bool InputLog::save(string path) const
+{
+	ofstream ofs(path);
+	if (!ofs)
+		return false;
+
+	ofs << LOG_MAGIC << ' ' << LOG_VERSION << '\n'
+		<< "seed " << m_seed << '\n';
+	for (size_t k = 0; k < m_keys.size(); k++)
+		ofs << "key " << m_keys[k].tick << ' ' << m_keys[k].key << '\n';
+	for (size_t k = 0; k < m_deaths.size(); k++)
+		ofs << "death " << m_deaths[k] << '\n';
+	if (m_finished)
+		ofs << "end " << m_outcome.ticks << ' ' << m_outcome.score << ' '
+			<< m_outcome.level << ' ' << m_outcome.lives << ' '
+			<< (m_outcome.gameOver ? 1 : 0) << '\n';
+	return static_cast<bool>(ofs);
+}
+
+bool InputLog::load(string path)
+{
+	ifstream ifs(path);
+	if (!ifs)
+		return false;
+
+	string magic;
+	int version;
+	if (!(ifs >> magic >> version)  ||  magic != LOG_MAGIC  ||  version != LOG_VERSION)
+		return false;
+
+	start(0);
+	string line;
+	getline(ifs, line);		// rest of the header line
+	while (getline(ifs, line))
+	{
+		istringstream iss(line);
+		string what;
+		if (!(iss >> what))
+			continue;		// blank line
+		if (what == "seed")
+		{
+			if (!(iss >> m_seed))
+				return false;
+		}
+		else if (what == "key")
+		{
+			KeyEvent e;
+			if (!(iss >> e.tick >> e.key))
+				return false;
+			m_keys.push_back(e);
+		}
+		else if (what == "death")
+		{
+			long tick;
+			if (!(iss >> tick))
+				return false;
+			m_deaths.push_back(tick);
+		}
+		else if (what == "end")
+		{
+			int gameOver;
+			if (!(iss >> m_outcome.ticks >> m_outcome.score >> m_outcome.level
+					  >> m_outcome.lives >> gameOver))
+				return false;
+			m_outcome.gameOver = (gameOver != 0);
+			m_finished = true;
+		}
+		else
+			return false;
+	}
+	return true;
+}
+
+string InputLog::divergence(const InputLog& replayed) const
+{
+	ostringstream oss;
+	for (size_t k = 0; k < m_deaths.size()  ||  k < replayed.m_deaths.size(); k++)
+	{
+		if (k >= replayed.m_deaths.size())
+		{
+			oss << "life " << k+1 << " was lost on tick " << m_deaths[k]
+				<< " in the recording but not in the replay";
+			return oss.str();
+		}
+		if (k >= m_deaths.size())
+		{
+			oss << "life " << k+1 << " was lost on tick " << replayed.m_deaths[k]
+				<< " in the replay but not in the recording";
+			return oss.str();
+		}
+		if (m_deaths[k] != replayed.m_deaths[k])
+		{
+			oss << "life " << k+1 << " was lost on tick " << replayed.m_deaths[k]
+				<< " in the replay but on tick " << m_deaths[k] << " in the recording";
+			return oss.str();
+		}
+	}
+
+	if (!m_finished  ||  !replayed.m_finished)
+		return "";		// nothing more to compare against
+
+	const Outcome& a = m_outcome;
+	const Outcome& b = replayed.m_outcome;
+	if (a.score != b.score)
+		oss << "final score " << b.score << ", recorded " << a.score;
+	else if (a.level != b.level)
+		oss << "final level " << b.level << ", recorded " << a.level;
+	else if (a.lives != b.lives)
+		oss << "final lives " << b.lives << ", recorded " << a.lives;
+	else if (a.ticks != b.ticks)
+		oss << "ran " << b.ticks << " ticks, recorded " << a.ticks;
+	return oss.str();
+}
@@ -0,0 +1,91 @@
+#ifndef INPUTLOG_H_
+#define INPUTLOG_H_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+  // Everything needed to play a game again exactly: the seed the world's
+  // generator started from and every key the world was handed through
+  // GameWorld::getKey, tagged with the tick it arrived on.  The ticks the
+  // player died on and the final result are kept too, so a replay can tell
+  // whether it reproduced the original game.
+  //
+  // Saved as text, one record per line:
+  //
+  //	GRLOG 1
+  //	seed <seed>
+  //	key <tick> <key>
+  //	death <tick>
+  //	end <ticks> <score> <level> <lives> <gameOver>
+
+class InputLog
+{
+  public:
+	struct KeyEvent
+	{
+		long	tick;
+		int		key;
+	};
+
+	struct Outcome
+	{
+		long	ticks;
+		int		score;
+		int		level;
+		int		lives;
+		bool	gameOver;
+	};
+
+	InputLog();
+
+	  // Forget everything and start a log for a world seeded with seed.
+	void start(std::uint64_t seed);
+
+	void recordKey(long tick, int key);
+	void recordDeath(long tick);
+	void finish(const Outcome& outcome);
+
+	std::uint64_t seed() const
+	{
+		return m_seed;
+	}
+
+	const std::vector<KeyEvent>& keys() const
+	{
+		return m_keys;
+	}
+
+	const std::vector<long>& deaths() const
+	{
+		return m_deaths;
+	}
+
+	bool finished() const
+	{
+		return m_finished;
+	}
+
+	const Outcome& outcome() const
+	{
+		return m_outcome;
+	}
+
+	bool save(std::string path) const;
+	bool load(std::string path);
+
+	  // Compares a log recorded while replaying this one against it.
+	  // Returns an empty string if the replay died on the same ticks and
+	  // ended with the same score, level and lives; otherwise describes the
+	  // first difference.
+	std::string divergence(const InputLog& replayed) const;
+
+  private:
+	std::uint64_t			m_seed;
+	std::vector<KeyEvent>	m_keys;
+	std::vector<long>		m_deaths;
+	Outcome					m_outcome;
+	bool					m_finished;
+};
+
+#endif // INPUTLOG_H_
@@ -0,0 +1,81 @@
+#ifndef KEYQUEUE_H_
+#define KEYQUEUE_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+  // Key presses on their way from the window system to the simulation,
+  // each stamped with when it happened.  One thread pushes (the keyboard
+  // callbacks) and one thread takes (whoever runs the ticks); they may be
+  // the same thread or different ones, and neither ever blocks or locks.
+  // The queue holds CAPACITY presses; a press that finds it full is
+  // dropped, since the simulation is that far behind the keyboard anyway.
+
+class KeyQueue
+{
+  public:
+	typedef std::chrono::steady_clock Clock;
+
+	struct Event
+	{
+		int					key;
+		Clock::time_point	time;
+	};
+
+	static const std::size_t CAPACITY = 64;		// a power of two
+
+	KeyQueue()
+	 : m_head(0), m_tail(0)
+	{
+	}
+
+	  // Producer side.
+	bool push(int key, Clock::time_point time)
+	{
+		std::size_t tail = m_tail.load(std::memory_order_relaxed);
+		if (tail - m_head.load(std::memory_order_acquire) == CAPACITY)
+			return false;
+		Event& slot = m_events[tail & (CAPACITY - 1)];
+		slot.key = key;
+		slot.time = time;
+		m_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	  // Consumer side: look at the oldest press without taking it...
+	bool peek(Event& event) const
+	{
+		std::size_t head = m_head.load(std::memory_order_relaxed);
+		if (head == m_tail.load(std::memory_order_acquire))
+			return false;
+		event = m_events[head & (CAPACITY - 1)];
+		return true;
+	}
+
+	  // ...take it (only after a successful peek)...
+	void pop()
+	{
+		m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+	  // ...or throw away everything pushed so far.
+	void clear()
+	{
+		m_head.store(m_tail.load(std::memory_order_acquire), std::memory_order_release);
+	}
+
+  private:
+	  // the two ends on separate cache lines, so the threads don't fight over one
+	alignas(64) std::atomic<std::size_t>	m_head;		// next to take; written by the consumer
+	alignas(64) std::atomic<std::size_t>	m_tail;		// next free slot; written by the producer
+	Event									m_events[CAPACITY];
+
+	static_assert((CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be a power of two");
+
+	  // Prevent copying or assigning queues
+	KeyQueue(const KeyQueue&);
+	KeyQueue& operator=(const KeyQueue&);
+};
+
+#endif // KEYQUEUE_H_
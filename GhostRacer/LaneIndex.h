@@ -0,0 +1,129 @@
+#ifndef LANEINDEX_H_
+#define LANEINDEX_H_
+
+#include "Actor.h"
+#include <vector>
+#include <algorithm>    //for std::lower_bound, std::upper_bound, std::swap
+
+//Collision-avoidance-worthy actors filed by lane bucket and sorted by y, so the cab queries
+//("closest one in front of me", "lowest one in lane 2") are a binary search instead of a scan
+//of every actor. Entries for actors that died this tick are left in until the world removes
+//the actor, so every query skips the dead.
+class LaneIndex
+{
+public:
+    static constexpr int NUM_BUCKETS = 4;                         //bucket 0 is off-road, buckets 1-3 are lanes 1-3
+
+    void clear(){
+        for (int b = 0; b < NUM_BUCKETS; b++)
+            m_lanes[b].clear();
+    }
+
+    void insert(const int& bucket, const double& y, Actor* a){
+        std::vector<Entry>& lane = m_lanes[bucket];
+        Entry entry;
+        entry.y = y;
+        entry.actor = a;
+        lane.insert(std::upper_bound(lane.begin(), lane.end(), y, yBeforeEntry), entry);
+    }
+
+    void erase(const int& bucket, const double& y, Actor* a){
+        std::vector<Entry>& lane = m_lanes[bucket];
+        std::vector<Entry>::iterator it = find(lane, y, a);
+        if (it != lane.end())
+            lane.erase(it);
+    }
+
+    //re-files a after it moved from (oldBucket, oldY) to (newBucket, newY)
+    void move(const int& oldBucket, const double& oldY, const int& newBucket, const double& newY, Actor* a){
+        std::vector<Entry>& lane = m_lanes[oldBucket];
+        std::vector<Entry>::iterator it = find(lane, oldY, a);
+        if (it == lane.end())
+            return;                                             //not indexed
+        if (oldBucket != newBucket){
+            lane.erase(it);
+            insert(newBucket, newY, a);
+            return;
+        }
+        //same lane: update y and slide the entry into place (usually it doesn't move at all since everything scrolls together)
+        it->y = newY;
+        while (it != lane.begin() && (it-1)->y > it->y){
+            std::swap(*it, *(it-1));
+            it--;
+        }
+        while (it+1 != lane.end() && (it+1)->y < it->y){
+            std::swap(*it, *(it+1));
+            it++;
+        }
+    }
+
+    //y of the first live entry strictly above y (returns false if there is none)
+    bool firstAbove(const int& bucket, const double& y, double& foundY) const{
+        const std::vector<Entry>& lane = m_lanes[bucket];
+        for (std::vector<Entry>::const_iterator it = std::upper_bound(lane.begin(), lane.end(), y, yBeforeEntry); it != lane.end(); it++){
+            if (it->actor->isAlive()){
+                foundY = it->y;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    //y of the last live entry strictly below y (returns false if there is none)
+    bool lastBelow(const int& bucket, const double& y, double& foundY) const{
+        const std::vector<Entry>& lane = m_lanes[bucket];
+        std::vector<Entry>::const_iterator it = std::lower_bound(lane.begin(), lane.end(), y, entryBeforeY);
+        while (it != lane.begin()){
+            it--;
+            if (it->actor->isAlive()){
+                foundY = it->y;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool lowest(const int& bucket, double& foundY) const{
+        const std::vector<Entry>& lane = m_lanes[bucket];
+        for (std::vector<Entry>::const_iterator it = lane.begin(); it != lane.end(); it++){
+            if (it->actor->isAlive()){
+                foundY = it->y;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool highest(const int& bucket, double& foundY) const{
+        const std::vector<Entry>& lane = m_lanes[bucket];
+        for (std::vector<Entry>::const_reverse_iterator it = lane.rbegin(); it != lane.rend(); it++){
+            if (it->actor->isAlive()){
+                foundY = it->y;
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    struct Entry{
+        double  y;                                              //y the actor was filed at (its current y)
+        Actor*  actor;
+    };
+    std::vector<Entry> m_lanes[NUM_BUCKETS];
+
+    static bool yBeforeEntry(const double& y, const Entry& e){
+        return y < e.y;
+    }
+    static bool entryBeforeY(const Entry& e, const double& y){
+        return e.y < y;
+    }
+    static std::vector<Entry>::iterator find(std::vector<Entry>& lane, const double& y, Actor* a){
+        std::vector<Entry>::iterator it = std::lower_bound(lane.begin(), lane.end(), y, entryBeforeY);
+        while (it != lane.end() && it->actor != a)
+            it++;
+        return it;
+    }
+};
+
+#endif // LANEINDEX_H_
@@ -0,0 +1,101 @@
+#include "MappedFile.h"
+#include <string>
+using namespace std;
+
+#ifdef _MSC_VER
+#include <windows.h>
+
+MappedFile::MappedFile()
+ : m_data(nullptr), m_size(0), m_file(INVALID_HANDLE_VALUE), m_mapping(nullptr)
+{
+}
+
+bool MappedFile::open(string path)
+{
+	close();
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+							  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size)  ||  size.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	void* view = (mapping != nullptr ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr);
+	if (view == nullptr)
+	{
+		if (mapping != nullptr)
+			CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+	m_file = file;
+	m_mapping = mapping;
+	m_data = static_cast<const unsigned char*>(view);
+	m_size = static_cast<size_t>(size.QuadPart);
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (m_data != nullptr)
+		UnmapViewOfFile(m_data);
+	if (m_mapping != nullptr)
+		CloseHandle(m_mapping);
+	if (m_file != INVALID_HANDLE_VALUE)
+		CloseHandle(m_file);
+	m_data = nullptr;
+	m_size = 0;
+	m_mapping = nullptr;
+	m_file = INVALID_HANDLE_VALUE;
+}
+
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+MappedFile::MappedFile()
+ : m_data(nullptr), m_size(0)
+{
+}
+
+bool MappedFile::open(string path)
+{
+	close();
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+	struct stat statbuf;
+	if (fstat(fd, &statbuf) != 0  ||  statbuf.st_size == 0)
+	{
+		::close(fd);
+		return false;
+	}
+	void* p = mmap(nullptr, static_cast<size_t>(statbuf.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);		// the mapping keeps the file itself alive
+	if (p == MAP_FAILED)
+		return false;
+	m_data = static_cast<const unsigned char*>(p);
+	m_size = static_cast<size_t>(statbuf.st_size);
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (m_data != nullptr)
+		munmap(const_cast<unsigned char*>(m_data), m_size);
+	m_data = nullptr;
+	m_size = 0;
+}
+
+#endif
+
+MappedFile::~MappedFile()
+{
+	close();
+}
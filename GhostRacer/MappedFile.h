@@ -0,0 +1,50 @@
+#ifndef MAPPEDFILE_H_
+#define MAPPEDFILE_H_
+
+#include <string>
+#include <cstddef>
+
+  // A whole file mapped read-only into memory.  Pages are read in by the OS
+  // as they are touched, so opening a big file costs nothing up front and
+  // only the parts actually used are ever read.
+
+class MappedFile
+{
+  public:
+	MappedFile();
+	~MappedFile();
+
+	  // Maps path, replacing whatever was mapped before.  Returns false (and
+	  // maps nothing) if the file can't be opened or is empty.
+	bool open(std::string path);
+	void close();
+
+	bool isOpen() const
+	{
+		return m_data != nullptr;
+	}
+
+	const unsigned char* data() const
+	{
+		return m_data;
+	}
+
+	std::size_t size() const
+	{
+		return m_size;
+	}
+
+  private:
+	const unsigned char*	m_data;
+	std::size_t				m_size;
+#ifdef _MSC_VER
+	void*					m_file;
+	void*					m_mapping;
+#endif
+
+	  // Prevent copying or assigning mappings
+	MappedFile(const MappedFile&);
+	MappedFile& operator=(const MappedFile&);
+};
+
+#endif // MAPPEDFILE_H_
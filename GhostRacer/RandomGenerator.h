@@ -0,0 +1,96 @@
+#ifndef RANDOMGENERATOR_H_
+#define RANDOMGENERATOR_H_
+
+#include <cstdint>
+#include <utility>
+
+  // xoshiro256** (Blackman and Vigna): 32 bytes of state, a handful of
+  // shifts and rotates per draw, and a period of 2^256 - 1.  Every world
+  // owns one, so a game replays exactly from its seed and worlds stepped on
+  // different threads never share one.
+
+class RandomGenerator
+{
+  public:
+	static const int STATE_WORDS = 4;
+
+	explicit RandomGenerator(std::uint64_t seed = 0)
+	{
+		this->seed(seed);
+	}
+
+	  // Restart the sequence.  The seed is spread over the whole state with
+	  // splitmix64, so nearby seeds (S, S+1, ...) give unrelated sequences.
+	void seed(std::uint64_t seed)
+	{
+		for (int k = 0; k < STATE_WORDS; k++)
+		{
+			seed += 0x9e3779b97f4a7c15ULL;
+			std::uint64_t z = seed;
+			z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+			z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+			m_state[k] = z ^ (z >> 31);
+		}
+	}
+
+	  // The whole generator, e.g. for a save state
+	void getState(std::uint64_t state[STATE_WORDS]) const
+	{
+		for (int k = 0; k < STATE_WORDS; k++)
+			state[k] = m_state[k];
+	}
+
+	void setState(const std::uint64_t state[STATE_WORDS])
+	{
+		for (int k = 0; k < STATE_WORDS; k++)
+			m_state[k] = state[k];
+	}
+
+	std::uint64_t next()
+	{
+		std::uint64_t result = rotl(m_state[1] * 5, 7) * 9;
+		std::uint64_t t = m_state[1] << 17;
+		m_state[2] ^= m_state[0];
+		m_state[3] ^= m_state[1];
+		m_state[1] ^= m_state[2];
+		m_state[0] ^= m_state[3];
+		m_state[2] ^= t;
+		m_state[3] = rotl(m_state[3], 45);
+		return result;
+	}
+
+	  // Uniformly distributed int from min to max, inclusive (the bounds may
+	  // come in either order).  Lemire's multiply-and-reject method: no
+	  // division except on the rare draw that would otherwise be biased.
+	int randInt(int min, int max)
+	{
+		if (max < min)
+			std::swap(max, min);
+		std::uint32_t range = static_cast<std::uint32_t>(max) - static_cast<std::uint32_t>(min) + 1;
+		if (range == 0)		// min..max spans every int
+			return static_cast<int>(static_cast<std::uint32_t>(next() >> 32));
+
+		std::uint64_t m = (next() >> 32) * range;
+		std::uint32_t low = static_cast<std::uint32_t>(m);
+		if (low < range)
+		{
+			std::uint32_t threshold = (0U - range) % range;
+			while (low < threshold)
+			{
+				m = (next() >> 32) * range;
+				low = static_cast<std::uint32_t>(m);
+			}
+		}
+		return static_cast<int>(static_cast<std::uint32_t>(min) + static_cast<std::uint32_t>(m >> 32));
+	}
+
+  private:
+	std::uint64_t m_state[STATE_WORDS];
+
+	static std::uint64_t rotl(std::uint64_t x, int k)
+	{
+		return (x << k) | (x >> (64 - k));
+	}
+};
+
+#endif // RANDOMGENERATOR_H_
@@ -0,0 +1,243 @@
+#include "ReplayFile.h"
+#include "HeadlessController.h"
+#include "GameWorld.h"
+#include "StateStream.h"
+#include <fstream>
+#include <algorithm>
+#include <limits>
+using namespace std;
+
+static const uint32_t REPLAY_MAGIC = 0x50525247;	// "GRRP"
+static const uint32_t REPLAY_VERSION = 3;		// 2: actor records written as one raw block, 3: movement from TrigTable
+
+static uint64_t alignedTo8(uint64_t offset)
+{
+	return (offset + 7) / 8 * 8;
+}
+
+bool ReplayFile::write(string path, const InputLog& log, GameWorld* gw, long keyframeInterval)
+{
+	if (keyframeInterval < 1)
+		keyframeInterval = 1;
+
+	gw->seedRandom(log.seed());
+	InputLog replayed;
+	gw->startRecording(&replayed);
+
+	  // Keyframe save states back to back, each 8-byte aligned; their offsets
+	  // are relative to the start of this block until the layout is known.
+	StateWriter states;
+	vector<IndexEntry> index;
+	auto addKeyframe = [&states, &index](GameWorld& w, bool needInit) {
+		IndexEntry entry;
+		entry.tick = w.getTick();
+		entry.needInit = needInit;
+		entry.stateOffset = states.size();
+		w.saveState(states);
+		entry.stateSize = states.size() - entry.stateOffset;
+		states.align(8);
+		index.push_back(entry);
+	};
+
+	addKeyframe(*gw, true);		// tick 0, before the first level starts
+	HeadlessController controller(log);
+	controller.setTickCallback([&addKeyframe, keyframeInterval](GameWorld& w, bool needInit) {
+		if (w.getTick() % keyframeInterval == 0)
+			addKeyframe(w, needInit);
+	});
+	long maxTicks = (log.finished() ? log.outcome().ticks : numeric_limits<long>::max());
+	controller.run(gw, maxTicks);
+	gw->stopRecording();
+	gw->setController(nullptr);
+
+	  // The keys this replay was actually handed, as (tick delta, key) varints
+	const vector<InputLog::KeyEvent>& events = replayed.keys();
+	StateWriter keys;
+	vector<uint64_t> keyOffsets;
+	long previousTick = 0;
+	for (size_t k = 0; k < events.size(); k++)
+	{
+		keyOffsets.push_back(keys.size());
+		keys.putVarint(static_cast<uint64_t>(events[k].tick - previousTick));
+		keys.putVarint(static_cast<uint32_t>(events[k].key));
+		previousTick = events[k].tick;
+	}
+	keyOffsets.push_back(keys.size());
+
+	Header header;
+	header.magic = REPLAY_MAGIC;
+	header.version = REPLAY_VERSION;
+	header.seed = replayed.seed();
+	header.ticks = replayed.outcome().ticks;
+	header.keyframeInterval = keyframeInterval;
+	header.score = replayed.outcome().score;
+	header.level = replayed.outcome().level;
+	header.lives = replayed.outcome().lives;
+	header.gameOver = replayed.outcome().gameOver;
+	header.numDeaths = replayed.deaths().size();
+	header.deathsOffset = sizeof(Header);
+	header.numKeys = events.size();
+	header.keysOffset = alignedTo8(header.deathsOffset + header.numDeaths * sizeof(int64_t));
+	header.keysSize = keys.size();
+	uint64_t statesOffset = alignedTo8(header.keysOffset + header.keysSize);
+	header.numKeyframes = index.size();
+	header.indexOffset = alignedTo8(statesOffset + states.size());
+
+	for (size_t k = 0; k < index.size(); k++)
+	{
+		index[k].stateOffset += statesOffset;
+		  // first key on or after the keyframe's tick
+		size_t first = lower_bound(events.begin(), events.end(), static_cast<long>(index[k].tick),
+					[](const InputLog::KeyEvent& e, long tick) { return e.tick < tick; }) - events.begin();
+		index[k].keyOffset = keyOffsets[first];
+		index[k].keyBaseTick = (first > 0 ? events[first-1].tick : 0);
+	}
+
+	StateWriter out;
+	out.put(header);
+	for (size_t k = 0; k < replayed.deaths().size(); k++)
+		out.put(static_cast<int64_t>(replayed.deaths()[k]));
+	out.align(8);
+	out.putBytes(keys.data(), keys.size());
+	out.align(8);
+	out.putBytes(states.data(), states.size());
+	out.align(8);
+	for (size_t k = 0; k < index.size(); k++)
+		out.put(index[k]);
+
+	ofstream ofs(path, ios::binary);
+	if (!ofs)
+		return false;
+	ofs.write(reinterpret_cast<const char*>(out.data()), out.size());
+	return static_cast<bool>(ofs);
+}
+
+ReplayFile::ReplayFile()
+ : m_lastKeyframeTick(0)
+{
+	m_header = Header();
+}
+
+bool ReplayFile::open(string path)
+{
+	close();
+	if (!m_file.open(path))
+		return false;
+
+	StateReader in(m_file.data(), m_file.size());
+	uint64_t size = m_file.size();
+	if (!in.get(m_header)  ||  m_header.magic != REPLAY_MAGIC  ||  m_header.version != REPLAY_VERSION
+		||  m_header.deathsOffset + m_header.numDeaths * sizeof(int64_t) > size
+		||  m_header.keysOffset + m_header.keysSize > size
+		||  m_header.numKeyframes == 0
+		||  m_header.indexOffset + m_header.numKeyframes * sizeof(IndexEntry) > size)
+	{
+		close();
+		return false;
+	}
+	return true;
+}
+
+void ReplayFile::close()
+{
+	m_file.close();
+	m_header = Header();
+}
+
+InputLog::Outcome ReplayFile::outcome() const
+{
+	InputLog::Outcome outcome;
+	outcome.ticks = ticks();
+	outcome.score = m_header.score;
+	outcome.level = m_header.level;
+	outcome.lives = m_header.lives;
+	outcome.gameOver = (m_header.gameOver != 0);
+	return outcome;
+}
+
+vector<long> ReplayFile::deaths() const
+{
+	vector<long> result;
+	StateReader in(m_file.data() + m_header.deathsOffset, m_header.numDeaths * sizeof(int64_t));
+	int64_t tick;
+	while (in.get(tick))
+		result.push_back(static_cast<long>(tick));
+	return result;
+}
+
+bool ReplayFile::readIndexEntry(size_t k, IndexEntry& entry) const
+{
+	StateReader in(m_file.data() + m_header.indexOffset + k * sizeof(IndexEntry), sizeof(IndexEntry));
+	return in.get(entry);
+}
+
+bool ReplayFile::decodeKeys(uint64_t offset, uint64_t baseTick, long untilTick, InputLog& keys) const
+{
+	if (offset > m_header.keysSize)
+		return false;
+	StateReader in(m_file.data() + m_header.keysOffset + offset, m_header.keysSize - offset);
+	long tick = static_cast<long>(baseTick);
+	while (!in.atEnd())
+	{
+		uint64_t delta, key;
+		if (!in.getVarint(delta)  ||  !in.getVarint(key))
+			return false;
+		tick += static_cast<long>(delta);
+		if (tick >= untilTick)
+			break;
+		keys.recordKey(tick, static_cast<int>(static_cast<uint32_t>(key)));
+	}
+	return true;
+}
+
+bool ReplayFile::seek(GameWorld* gw, long tick) const
+{
+	if (!m_file.isOpen()  ||  tick < 0  ||  tick > ticks())
+		return false;
+
+	  // last keyframe at or before tick (the first one is at tick 0)
+	size_t lo = 0;
+	size_t hi = numKeyframes();
+	IndexEntry entry;
+	while (hi - lo > 1)
+	{
+		size_t mid = lo + (hi - lo) / 2;
+		if (!readIndexEntry(mid, entry))
+			return false;
+		if (static_cast<long>(entry.tick) <= tick)
+			lo = mid;
+		else
+			hi = mid;
+	}
+	if (!readIndexEntry(lo, entry)  ||  static_cast<long>(entry.tick) > tick
+		||  entry.stateOffset + entry.stateSize > m_file.size())
+		return false;
+
+	StateReader in(m_file.data() + entry.stateOffset, entry.stateSize);
+	if (!gw->restoreState(in))
+		return false;
+
+	InputLog keys;
+	keys.start(m_header.seed);
+	if (!decodeKeys(entry.keyOffset, entry.keyBaseTick, tick, keys))
+		return false;
+	HeadlessController controller(keys);
+	controller.resume(gw, tick, entry.needInit != 0);
+	gw->setController(nullptr);		// the controller goes away with this call
+	m_lastKeyframeTick = static_cast<long>(entry.tick);
+	return true;
+}
+
+InputLog ReplayFile::inputLog() const
+{
+	InputLog log;
+	log.start(m_header.seed);
+	if (!m_file.isOpen())
+		return log;
+	decodeKeys(0, 0, numeric_limits<long>::max(), log);
+	vector<long> d = deaths();
+	for (size_t k = 0; k < d.size(); k++)
+		log.recordDeath(d[k]);
+	log.finish(outcome());
+	return log;
+}
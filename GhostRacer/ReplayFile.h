@@ -0,0 +1,123 @@
+#ifndef REPLAYFILE_H_
+#define REPLAYFILE_H_
+
+#include "InputLog.h"
+#include "MappedFile.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+class GameWorld;
+
+  // A recorded game that can be entered at any tick without replaying it
+  // from the start.  The file holds
+  //
+  //	a fixed header (seed, length, final result, where everything is),
+  //	the ticks the player died on,
+  //	every key the world was handed, as varint (tick delta, key) pairs,
+  //	a full world save state every keyframeInterval ticks, and
+  //	an index of fixed-size entries, one per keyframe, giving its tick and
+  //	where its save state and the keys from that tick on start.
+  //
+  // It is read through a MappedFile, so opening it reads nothing but the
+  // header; seeking binary-searches the index, restores the nearest
+  // keyframe at or before the target and simulates the rest of the way
+  // (fewer than keyframeInterval ticks).
+
+class ReplayFile
+{
+  public:
+	  // Plays log on gw (a fresh world; it is seeded from the log) and writes
+	  // the replay, with its keyframes, to path.  The result recorded is what
+	  // this replay produced, which only differs from log's own if the game
+	  // has changed since it was recorded.  Returns false if path can't be
+	  // written.
+	static bool write(std::string path, const InputLog& log, GameWorld* gw, long keyframeInterval);
+
+	ReplayFile();
+
+	bool open(std::string path);
+	void close();
+
+	std::uint64_t seed() const
+	{
+		return m_header.seed;
+	}
+
+	  // Length of the game in ticks
+	long ticks() const
+	{
+		return static_cast<long>(m_header.ticks);
+	}
+
+	long keyframeInterval() const
+	{
+		return static_cast<long>(m_header.keyframeInterval);
+	}
+
+	std::size_t numKeyframes() const
+	{
+		return static_cast<std::size_t>(m_header.numKeyframes);
+	}
+
+	  // The recorded result, deaths included
+	InputLog::Outcome outcome() const;
+	std::vector<long> deaths() const;
+
+	  // Puts gw into the state the recorded game was in after tick steps
+	  // (0 <= tick <= ticks()).  gw must be the same kind of world the
+	  // replay was written with; any level it was running is discarded.
+	  // Returns false if the file is damaged or tick is out of range.
+	bool seek(GameWorld* gw, long tick) const;
+
+	  // Every key in the replay, e.g. to play it from the start instead
+	InputLog inputLog() const;
+
+	  // How the last seek got there: the keyframe it restored and how many
+	  // ticks it then simulated
+	long lastKeyframeTick() const
+	{
+		return m_lastKeyframeTick;
+	}
+
+  private:
+	struct Header
+	{
+		std::uint32_t	magic;
+		std::uint32_t	version;
+		std::uint64_t	seed;
+		std::uint64_t	ticks;
+		std::uint64_t	keyframeInterval;
+		std::int32_t	score;
+		std::int32_t	level;
+		std::int32_t	lives;
+		std::uint32_t	gameOver;
+		std::uint64_t	numDeaths;
+		std::uint64_t	deathsOffset;
+		std::uint64_t	numKeys;
+		std::uint64_t	keysOffset;
+		std::uint64_t	keysSize;
+		std::uint64_t	numKeyframes;
+		std::uint64_t	indexOffset;
+	};
+
+	struct IndexEntry
+	{
+		std::uint64_t	tick;
+		std::uint64_t	needInit;		// the keyframe is between levels
+		std::uint64_t	stateOffset;
+		std::uint64_t	stateSize;
+		std::uint64_t	keyOffset;		// first key on or after tick, relative to keysOffset
+		std::uint64_t	keyBaseTick;	// tick the delta of that key counts from
+	};
+
+	MappedFile		m_file;
+	Header			m_header;
+	mutable long	m_lastKeyframeTick;
+
+	bool readIndexEntry(std::size_t k, IndexEntry& entry) const;
+	bool decodeKeys(std::uint64_t offset, std::uint64_t baseTick, long untilTick, InputLog& keys) const;
+};
+
+#endif // REPLAYFILE_H_
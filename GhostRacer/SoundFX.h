@@ -4,6 +4,7 @@
 #define SOUNDFX_H_
 
 #include <string>
+#include <cstddef>
 
 #if defined(_MSC_VER)
 
@@ -21,6 +22,21 @@ class SoundFXController
 			m_engine->play2D(soundFile.c_str(), false);
 	}
 
+	  // Plays a WAV already in memory (say, in a mapped asset bundle) that
+	  // stays put for the rest of the game; it is decoded from there, under
+	  // soundFile's name, without reading the file.
+	void playClip(std::string soundFile, const unsigned char* data, std::size_t size)
+	{
+		if (m_engine == nullptr)
+			return;
+		irrklang::ISoundSource* source = m_engine->getSoundSource(soundFile.c_str(), false);
+		if (source == nullptr)
+			source = m_engine->addSoundSourceFromMemory(const_cast<unsigned char*>(data),
+									static_cast<irrklang::ik_s32>(size), soundFile.c_str(), false);
+		if (source != nullptr)
+			m_engine->play2D(source, false);
+	}
+
 	void abortClip()
 	{
 		if (m_engine != nullptr)
@@ -73,6 +89,12 @@ class SoundFXController
         //abortClip();  // stop anything currently playing
         pidValid = (posix_spawn(&pid, argv[0], nullptr, nullptr, argv, nullptr) == 0);
     }
+
+      // afplay only plays files, so a clip from memory plays its file
+    void playClip(std::string soundFile, const unsigned char*, std::size_t)
+    {
+        playClip(soundFile);
+    }
     
     void abortClip()
     {
@@ -94,6 +116,7 @@ class SoundFXController
 {
   public:
     void playClip(std::string) {}
+    void playClip(std::string, const unsigned char*, std::size_t) {}
     void abortClip() {}
     static SoundFXController& getInstance();
 };
@@ -0,0 +1,192 @@
+#include "SpriteAtlas.h"
+#include <fstream>
+#include <memory>
+#include <algorithm>
+using namespace std;
+
+bool SpriteAtlas::loadTga(string path, Frame& frame)
+{
+	ifstream tgaFile(path, ios::in|ios::binary);
+	if (!tgaFile)
+		return false;
+
+	char type[3];
+	char info[6];
+
+	  // Read file header info
+	tgaFile.read(type, 3);
+	tgaFile.seekg(12);
+	tgaFile.read(info, 6);
+	unsigned int textureWidth = static_cast<unsigned char>(info[0]) + static_cast<unsigned char>(info[1]) * 256;
+	unsigned int textureHeight = static_cast<unsigned char>(info[2]) + static_cast<unsigned char>(info[3]) * 256;
+	unsigned char byteCount = static_cast<unsigned char>(info[4]) / 8;
+
+	  //image type either 2 (color) or 3 (greyscale)
+	if (!tgaFile  ||  type[1] != 0  ||  (type[2] != 2  &&  type[2] != 3))
+		return false;
+
+	if (byteCount != 3  &&  byteCount != 4)
+		return false;
+
+	long imageSize = textureWidth * textureHeight * byteCount;
+	unique_ptr<char[]> imageData(new char[imageSize]);
+	tgaFile.seekg(18);
+	  // Read image data
+	tgaFile.read(imageData.get(), imageSize);
+	if (!tgaFile)
+		return false;
+
+	  // Always BGRA from here on
+	frame.width = textureWidth;
+	frame.height = textureHeight;
+	frame.bgra.resize(static_cast<size_t>(textureWidth) * textureHeight * 4);
+	for (size_t p = 0; p < static_cast<size_t>(textureWidth) * textureHeight; p++)
+	{
+		const unsigned char* src = reinterpret_cast<const unsigned char*>(imageData.get()) + p * byteCount;
+		unsigned char* dst = &frame.bgra[p * 4];
+		dst[0] = src[0];
+		dst[1] = src[1];
+		dst[2] = src[2];
+		dst[3] = (byteCount == 4 ? src[3] : 255);
+	}
+	return true;
+}
+
+  // Lays frames out in shelves atlasWidth wide, in the given order, and
+  // returns how tall that comes to.  Where each frame's padded cell starts
+  // goes in cellX and cellY, if they aren't null.
+unsigned int SpriteAtlas::shelfPack(const vector<Frame>& frames, const vector<size_t>& order, unsigned int atlasWidth,
+									vector<unsigned int>* cellX, vector<unsigned int>* cellY)
+{
+	unsigned int x = 0, y = 0, shelfHeight = 0;
+	for (size_t k = 0; k < order.size(); k++)
+	{
+		const Frame& frame = frames[order[k]];
+		unsigned int cellWidth = paddedSize(frame.width);
+		if (x + cellWidth > atlasWidth)
+		{
+			x = 0;
+			y += shelfHeight;
+			shelfHeight = 0;
+		}
+		if (cellX != nullptr)
+		{
+			(*cellX)[order[k]] = x;
+			(*cellY)[order[k]] = y;
+		}
+		x += cellWidth;
+		shelfHeight = max(shelfHeight, paddedSize(frame.height));
+	}
+	return y + shelfHeight;
+}
+
+bool SpriteAtlas::build(const vector<Frame>& frames, unsigned int maxSize, bool mipmapped)
+{
+	m_width = m_height = 0;
+	m_levels.clear();
+	m_placements.clear();
+
+	  // shelf packing, tallest frames first
+	vector<size_t> order(frames.size());
+	for (size_t k = 0; k < order.size(); k++)
+		order[k] = k;
+	stable_sort(order.begin(), order.end(), [&frames](size_t a, size_t b) {
+		return frames[a].height > frames[b].height;
+	});
+
+	  // every width the widest frame allows, keeping the one that packs into
+	  // the least area; the height is just what the shelves take up
+	unsigned int widest = PADDING;
+	for (size_t k = 0; k < frames.size(); k++)
+		widest = max(widest, paddedSize(frames[k].width));
+	unsigned int atlasWidth = 0, atlasHeight = 0;
+	for (unsigned int width = widest; width <= min(MAX_WIDTH, maxSize); width += PADDING)
+	{
+		unsigned int height = shelfPack(frames, order, width, nullptr, nullptr);
+		if (height <= maxSize  &&  (atlasWidth == 0  ||
+									static_cast<size_t>(width) * height < static_cast<size_t>(atlasWidth) * atlasHeight))
+		{
+			atlasWidth = width;
+			atlasHeight = height;
+		}
+	}
+	if (atlasWidth == 0)
+		return false;
+	vector<unsigned int> cellX(frames.size()), cellY(frames.size());
+	shelfPack(frames, order, atlasWidth, &cellX, &cellY);
+
+	m_levels.emplace_back(static_cast<size_t>(atlasWidth) * atlasHeight * 4, 0);
+	vector<unsigned char>& atlas = m_levels[0];
+	for (size_t k = 0; k < frames.size(); k++)
+	{
+		const Frame& frame = frames[k];
+		int w = static_cast<int>(frame.width), h = static_cast<int>(frame.height);
+		for (int row = -PADDING; row < h + PADDING; row++)
+		{
+			int srcRow = min(max(row, 0), h - 1);
+			unsigned char* dst = &atlas[((cellY[k] + PADDING + row) * static_cast<size_t>(atlasWidth) + cellX[k]) * 4];
+			for (int col = -PADDING; col < w + PADDING; col++, dst += 4)
+			{
+				int srcCol = min(max(col, 0), w - 1);
+				const unsigned char* src = &frame.bgra[(static_cast<size_t>(srcRow) * w + srcCol) * 4];
+				copy(src, src + 4, dst);
+			}
+		}
+
+		Placement placed;
+		placed.imageID = frame.imageID;
+		placed.frameNum = frame.frameNum;
+		placed.u0 = static_cast<float>(cellX[k] + PADDING) / atlasWidth;
+		placed.v0 = static_cast<float>(cellY[k] + PADDING) / atlasHeight;
+		placed.u1 = static_cast<float>(cellX[k] + PADDING + w) / atlasWidth;
+		placed.v1 = static_cast<float>(cellY[k] + PADDING + h) / atlasHeight;
+		m_placements.push_back(placed);
+	}
+	m_width = atlasWidth;
+	m_height = atlasHeight;
+
+	if (mipmapped)
+	{
+		for (size_t k = 0; levelSize(m_width, k) > 1  ||  levelSize(m_height, k) > 1; k++)
+		{
+			vector<unsigned char> next;
+			halve(m_levels[k], levelSize(m_width, k), levelSize(m_height, k), next);
+			m_levels.push_back(move(next));
+		}
+	}
+	return true;
+}
+
+  // Space a frame takes in the atlas: the frame, padding on both sides,
+  // rounded up so the next cell starts on a multiple of PADDING
+unsigned int SpriteAtlas::paddedSize(unsigned int size)
+{
+	unsigned int padded = size + 2 * PADDING;
+	return (padded + PADDING - 1) / PADDING * PADDING;
+}
+
+  // The next mipmap level: each texel the rounded average of the 2x2 (or,
+  // once a side is down to 1, 2x1) block it covers, as gluBuild2DMipmaps
+  // makes them.
+void SpriteAtlas::halve(const vector<unsigned char>& from, unsigned int width, unsigned int height,
+						vector<unsigned char>& to)
+{
+	unsigned int toWidth = max(width / 2, 1u), toHeight = max(height / 2, 1u);
+	size_t dx = (width > 1 ? 4 : 0), dy = (height > 1 ? static_cast<size_t>(width) * 4 : 0);
+	to.resize(static_cast<size_t>(toWidth) * toHeight * 4);
+	for (unsigned int row = 0; row < toHeight; row++)
+	{
+		for (unsigned int col = 0; col < toWidth; col++)
+		{
+			const unsigned char* src = &from[((static_cast<size_t>(row) * (dy != 0 ? 2 : 1)) * width + col * (dx != 0 ? 2 : 1)) * 4];
+			unsigned char* dst = &to[(static_cast<size_t>(row) * toWidth + col) * 4];
+			for (int c = 0; c < 4; c++)
+			{
+				if (dx != 0  &&  dy != 0)
+					dst[c] = static_cast<unsigned char>((src[c] + src[c+dx] + src[c+dy] + src[c+dx+dy] + 2) / 4);
+				else
+					dst[c] = static_cast<unsigned char>((src[c] + src[c+dx+dy] + 1) / 2);
+			}
+		}
+	}
+}
@@ -0,0 +1,104 @@
+#ifndef SPRITEATLAS_H_
+#define SPRITEATLAS_H_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+  // Sprite frames packed into one texture, with its whole mipmap chain,
+  // built on the CPU without touching OpenGL.  SpriteManager builds one at
+  // startup from loose TGA files; GhostRacerBundle builds the same one
+  // offline and bakes it into an AssetBundle, so the game only has to
+  // upload it.
+
+class SpriteAtlas
+{
+  public:
+	  // A decoded frame, BGRA, rows bottom to top as in the TGA file
+	struct Frame
+	{
+		unsigned int				imageID;
+		unsigned int				frameNum;
+		unsigned int				width;
+		unsigned int				height;
+		std::vector<unsigned char>	bgra;
+	};
+
+	  // Where a frame ended up, in texture coordinates, padding excluded
+	struct Placement
+	{
+		std::uint32_t	imageID;
+		std::uint32_t	frameNum;
+		float			u0, v0, u1, v1;
+	};
+
+	  // Each frame is surrounded by PADDING texels copied from its own edges
+	  // and starts on a multiple of PADDING, so the mipmap levels a sprite is
+	  // drawn from (down to 1/PADDING size) never blend in texels from its
+	  // neighbors.
+	static const int PADDING = 16;
+	static const unsigned int MAX_WIDTH = 2048;
+
+	  // Reads an uncompressed 24- or 32-bit color or greyscale TGA into
+	  // frame (its imageID and frameNum are left alone).
+	static bool loadTga(std::string path, Frame& frame);
+
+	SpriteAtlas()
+	 : m_width(0), m_height(0)
+	{
+	}
+
+	  // Packs frames, in shelves of the tallest first, into the smallest
+	  // atlas it can find at most maxSize texels on a side (and MAX_WIDTH
+	  // wide), then builds its mipmap levels if mipmapped.  The atlas is
+	  // only as big as the frames need, so its sides needn't be powers of
+	  // two.  Returns false if they don't fit.
+	bool build(const std::vector<Frame>& frames, unsigned int maxSize, bool mipmapped = true);
+
+	unsigned int width() const
+	{
+		return m_width;
+	}
+
+	unsigned int height() const
+	{
+		return m_height;
+	}
+
+	  // Level 0 is the atlas itself; each level after it is half the size
+	  // of the one before (but never less than 1), down to 1x1.
+	std::size_t numLevels() const
+	{
+		return m_levels.size();
+	}
+
+	const std::vector<unsigned char>& level(std::size_t k) const
+	{
+		return m_levels[k];
+	}
+
+	static unsigned int levelSize(unsigned int size, std::size_t level)
+	{
+		size >>= level;
+		return size == 0 ? 1 : size;
+	}
+
+	const std::vector<Placement>& placements() const
+	{
+		return m_placements;
+	}
+
+  private:
+	unsigned int							m_width;
+	unsigned int							m_height;
+	std::vector<std::vector<unsigned char> >	m_levels;		// BGRA
+	std::vector<Placement>					m_placements;	// in the order the frames were given
+
+	static unsigned int paddedSize(unsigned int size);
+	static unsigned int shelfPack(const std::vector<Frame>& frames, const std::vector<std::size_t>& order,
+								  unsigned int atlasWidth, std::vector<unsigned int>* cellX, std::vector<unsigned int>* cellY);
+	static void halve(const std::vector<unsigned char>& from, unsigned int width, unsigned int height,
+					  std::vector<unsigned char>& to);
+};
+
+#endif // SPRITEATLAS_H_
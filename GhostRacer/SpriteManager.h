@@ -4,28 +4,27 @@
 #define SPRITEMANAGER_H_
 
 #include "freeglut.h"
-#include <memory>
-
-#ifndef GL_BGR
-#define GL_BGR GL_BGR_EXT
-#endif
 
 #ifndef GL_BGRA
 #define GL_BGRA GL_BGRA_EXT
 #endif
 
 #include "GameConstants.h"
+#include "SpriteAtlas.h"
+#include "AssetBundle.h"
 #include <iostream>
-#include <fstream>
 #include <string>
-#include <map>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
 
 class SpriteManager
 {
 public:
 
 	SpriteManager()
-	 : m_mipMapped(true)
+	 : m_mipMapped(true), m_atlasTexture(0)
 	{
 	}
 
@@ -34,125 +33,106 @@ public:
 		m_mipMapped = status;
 	}
 
+	  // Reads a sprite frame.  Frames are not handed to OpenGL one by one:
+	  // the first time anything is drawn (or when buildAtlas is called) every
+	  // frame loaded so far is packed into one atlas texture, so a whole
+	  // frame of sprites draws with a single texture bound.
 	bool loadSprite(std::string filename_tga, int imageID, int frameNum)
 	{
-		  // Load Texture Data From TGA File
-
 		unsigned int spriteID = getSpriteID(imageID, frameNum);
 		if (INVALID_SPRITE_ID == spriteID)
 			return false;
 
+		reserveImage(imageID);
 		m_frameCountPerSprite[imageID]++;	// keep track of how many frames per sprite we loaded
 
-		std::string line;
-		std::string contents = "";
-		std::ifstream tgaFile(filename_tga, std::ios::in|std::ios::binary);
-
-		if (!tgaFile)
-			return false;
-
-		char type[3];
-		char info[6];
-        
-          // Read file header info
-        tgaFile.read(type, 3);
-        tgaFile.seekg(12);
-        tgaFile.read(info, 6);
-        unsigned int textureWidth = static_cast<unsigned char>(info[0]) + static_cast<unsigned char>(info[1]) * 256;
-        unsigned int textureHeight = static_cast<unsigned char>(info[2]) + static_cast<unsigned char>(info[3]) * 256;
-        unsigned char byteCount = static_cast<unsigned char>(info[4]) / 8;
-        long imageSize = textureWidth * textureHeight * byteCount;
-        std::unique_ptr<char[]> imageData(new char[imageSize]);
-        tgaFile.seekg(18);
-          // Read image data
-		tgaFile.read(imageData.get(), imageSize);
-		if (!tgaFile)
+		  // Keep it as BGRA until the atlas is built
+		SpriteAtlas::Frame pending;
+		pending.imageID = imageID;
+		pending.frameNum = frameNum;
+		if (!SpriteAtlas::loadTga(filename_tga, pending))
 			return false;
+		m_pending.push_back(std::move(pending));
 
-		  //image type either 2 (color) or 3 (greyscale)
-		if (type[1] != 0 || (type[2] != 2 && type[2] != 3))
-			return false;
-
-		if (byteCount != 3 && byteCount != 4)
-			return false;
-
-		  // Transfer Texture To OpenGL
+		return true;
+	}
 
-		glEnable(GL_DEPTH_TEST);
+	  // Packs every frame loaded so far into one atlas texture (see
+	  // SpriteAtlas).  Returns false if the frames don't fit in the largest
+	  // texture the GL supports.
+	bool buildAtlas()
+	{
+		if (m_pending.empty())
+			return true;
 
-		  // allocate a texture handle
-		GLuint glTextureID;
-		glGenTextures(1, &glTextureID);
+		  // Frames already in an atlas go in again, so late loads still end
+		  // up in a single texture
+		for (std::size_t k = 0; k < m_loaded.size(); k++)
+			m_pending.push_back(std::move(m_loaded[k]));
+		m_loaded.clear();
 
-		  // bind our new texture
-		glBindTexture(GL_TEXTURE_2D, glTextureID);
+		SpriteAtlas atlas;
+		if (!atlas.build(m_pending, maxTextureSize(), m_mipMapped))
+			return false;
 
-		glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+		std::vector<const unsigned char*> levels;
+		for (std::size_t k = 0; k < atlas.numLevels(); k++)
+			levels.push_back(atlas.level(k).data());
+		uploadAtlas(atlas.width(), atlas.height(), levels);
+		for (std::size_t k = 0; k < atlas.placements().size(); k++)
+			placeFrame(atlas.placements()[k]);
 
-		if (m_mipMapped)
-		{
-			  // when texture area is small, bilinear filter the closest mipmap
-			glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-			  // when texture area is large, bilinear filter the first mipmap
-			glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-		}
-		else
-		{
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-		}
+		m_loaded = std::move(m_pending);
+		m_pending.clear();
+		return true;
+	}
 
-		  // Have the texture wrap both vertically and horizontally.
-		glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, static_cast<GLfloat>(GL_REPEAT));
-		glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, static_cast<GLfloat>(GL_REPEAT));
+	  // Takes every sprite frame from a bundle, whose atlas and mipmaps were
+	  // made offline, instead of loading and packing them here; OpenGL reads
+	  // each level straight out of the bundle's mapping.  Returns false if
+	  // the atlas is too big for the GL, in which case nothing is loaded.
+	bool loadAtlas(const AssetBundle& bundle)
+	{
+		unsigned int maxSize = maxTextureSize();
+		if (bundle.atlasWidth() > maxSize  ||  bundle.atlasHeight() > maxSize)
+			return false;
 
-		if (m_mipMapped)
-		{
-			  // build our texture mipmaps
-			  // byteCount of 3 means that BGR data is being supplied. byteCount of 4 means that BGRA data is being supplied.
-            makeMipmaps(byteCount, textureWidth, textureHeight, imageData.get());
-        }
-		else
+		std::vector<const unsigned char*> levels;
+		for (std::size_t k = 0; k < (m_mipMapped ? bundle.numLevels() : 1); k++)
+			levels.push_back(bundle.level(k));
+		uploadAtlas(bundle.atlasWidth(), bundle.atlasHeight(), levels);
+		for (std::size_t k = 0; k < bundle.numFrames(); k++)
 		{
-			  // byteCount of 3 means that BGR data is being supplied. byteCount of 4 means that BGRA data is being supplied.
-			if (3 == byteCount)
-				glTexImage2D(GL_TEXTURE_2D, 0, 3, textureWidth, textureHeight, 0, GL_BGR, GL_UNSIGNED_BYTE, imageData.get());
-			else if (4 == byteCount)
-				glTexImage2D(GL_TEXTURE_2D, 0, 4, textureWidth, textureHeight, 0, GL_BGRA, GL_UNSIGNED_BYTE, imageData.get());
+			SpriteAtlas::Placement placed = bundle.frame(k);
+			if (INVALID_SPRITE_ID == getSpriteID(placed.imageID, placed.frameNum))
+				continue;
+			reserveImage(placed.imageID);
+			m_frameCountPerSprite[placed.imageID]++;
+			placeFrame(placed);
 		}
-
-		m_imageMap[spriteID] = glTextureID;
-
 		return true;
 	}
 
 	unsigned int getNumFrames(int imageID) const
 	{
-		auto it = m_frameCountPerSprite.find(imageID);
-		if (it == m_frameCountPerSprite.end())
+		if (imageID < 0  ||  static_cast<std::size_t>(imageID) >= m_frameCountPerSprite.size())
 			return 0;
 
-		return it->second;
+		return m_frameCountPerSprite[imageID];
 	}
 
 
 	bool plotSprite(int imageID, int frame, double gx, double gy, double gz, int angleDegrees, double size)
 	{
-		unsigned int spriteID = getSpriteID(imageID,frame);
-		if (INVALID_SPRITE_ID == spriteID)
-			return false;
+		if (!m_pending.empty())
+			buildAtlas();
 
-		auto it = m_imageMap.find(spriteID);
-		if (it == m_imageMap.end())
+		const AtlasFrame* atlasFrame = findFrame(imageID, frame);
+		if (atlasFrame == nullptr)
 			return false;
 
 		glPushMatrix();
 
-		double finalWidth, finalHeight;
-
-		finalWidth = SPRITE_WIDTH_GL * size;
-		finalHeight = SPRITE_HEIGHT_GL * size;
-
 		// object's x/y location is center-based, but sprite plotting is upper-left-corner based
 		const double xoffset = 0;// finalWidth / 2;
 		const double yoffset = 0;// finalHeight / 2;
@@ -163,47 +143,22 @@ public:
 		glDisable(GL_DEPTH_TEST);
 		glEnable (GL_BLEND);
 		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-		glBindTexture(GL_TEXTURE_2D, it->second);
+		glBindTexture(GL_TEXTURE_2D, atlasFrame->texture);
 
 		glColor3f(1.0, 1.0, 1.0);
 
 		double cx1,cx2,cx3,cx4;
 		double cy1,cy2,cy3,cy4;
 
-		cx1 = cy1 = 0;
-		cx2 = 1; cy2 = 0;
-		cx3 = 1; cy3 = 1;
-		cx4 = 0; cy4 = 1;
-
-		double rx1, ry1, rx2, ry2, rx3, ry3, rx4, ry4;
+		  // the frame's rectangle in the atlas
+		cx1 = cx4 = atlasFrame->u0;
+		cx2 = cx3 = atlasFrame->u1;
+		cy1 = cy2 = atlasFrame->v0;
+		cy3 = cy4 = atlasFrame->v1;
 
-//#define FULL_ROTATION	// for games where you can rotate 360 degrees, not just n/s/e/w
-
-#ifndef FULL_ROTATION
-		if (angleDegrees != 180)
-		{
-			rotate(-finalWidth / 2, -finalHeight / 2, angleDegrees, rx1, ry1);
-			rotate(finalWidth / 2, -finalHeight / 2, angleDegrees, rx2, ry2);
-			rotate(finalWidth / 2, finalHeight / 2, angleDegrees, rx3, ry3);
-			rotate(-finalWidth / 2, finalHeight / 2, angleDegrees, rx4, ry4);
-		}
-		else
-		{
-			// Ensure actors rotated to face left aren't upside-down.
-			rotate(-finalWidth / 2, -finalHeight / 2, 0, rx1, ry1);
-			rotate(finalWidth / 2, -finalHeight / 2, 0, rx2, ry2);
-			rotate(finalWidth / 2, finalHeight / 2, 0, rx3, ry3);
-			rotate(-finalWidth / 2, finalHeight / 2, 0, rx4, ry4);
-			std::swap(rx1, rx2);
-			std::swap(rx3, rx4);
-		}
-#else
-		angleDegrees += 90;
-		rotate(-finalWidth / 2, -finalHeight / 2, angleDegrees, rx1, ry1);
-		rotate(finalWidth / 2, -finalHeight / 2, angleDegrees, rx2, ry2);
-		rotate(finalWidth / 2, finalHeight / 2, angleDegrees, rx3, ry3);
-		rotate(-finalWidth / 2, finalHeight / 2, angleDegrees, rx4, ry4);
-#endif  // FULL_ROTATION
+		const double* r = rotatedCorners(angleDegrees, size);
+		double rx1 = r[0], ry1 = r[1], rx2 = r[2], ry2 = r[3];
+		double rx3 = r[4], ry3 = r[5], rx4 = r[6], ry4 = r[7];
 
 		glBegin(GL_QUADS);
 		glTexCoord2d(cx1, cy1);
@@ -239,14 +194,256 @@ public:
 		return true;
 	}
 
+	  // Batched drawing, for a whole frame of sprites at once.  queueSprite
+	  // takes the same arguments as plotSprite plus the sprite's depth layer;
+	  // drawQueuedSprites then draws everything queued, deepest layer first
+	  // (as a frame of plotSprite calls walking the layers would), with the
+	  // sprites of each layer grouped by texture.  All the quads go into one
+	  // vertex array, the GL state is set up once, and each run of sprites
+	  // sharing a texture is a single glDrawArrays, so a frame is a handful
+	  // of draw calls instead of a dozen state changes per sprite (with every
+	  // frame in the atlas, one).  The arrays are kept from frame to frame.
+	bool queueSprite(int imageID, int frame, double gx, double gy, double gz, int angleDegrees, double size, unsigned int layer)
+	{
+		if (!m_pending.empty())
+			buildAtlas();
+
+		const AtlasFrame* atlasFrame = findFrame(imageID, frame);
+		if (atlasFrame == nullptr)
+			return false;
+
+		const double* r = rotatedCorners(angleDegrees, size);
+
+		QueuedSprite sprite;
+		sprite.layer = layer;
+		sprite.texture = atlasFrame->texture;
+		sprite.order = static_cast<unsigned int>(m_queue.size());
+		const GLfloat uv[8] = { atlasFrame->u0, atlasFrame->v0, atlasFrame->u1, atlasFrame->v0,
+								atlasFrame->u1, atlasFrame->v1, atlasFrame->u0, atlasFrame->v1 };
+		std::copy(uv, uv + 8, sprite.uv);
+		for (int k = 0; k < 4; k++)
+		{
+			sprite.xyz[3*k] = static_cast<GLfloat>(gx + r[2*k]);
+			sprite.xyz[3*k+1] = static_cast<GLfloat>(gy + r[2*k+1]);
+			sprite.xyz[3*k+2] = static_cast<GLfloat>(gz);
+		}
+		m_queue.push_back(sprite);
+		return true;
+	}
+
+	void drawQueuedSprites()
+	{
+		if (m_queue.empty())
+			return;
+
+		  // deepest layer first, then by texture; order queued breaks ties so
+		  // the frame comes out the same every time
+		std::sort(m_queue.begin(), m_queue.end(), [](const QueuedSprite& a, const QueuedSprite& b) {
+			if (a.layer != b.layer)
+				return a.layer > b.layer;
+			if (a.texture != b.texture)
+				return a.texture < b.texture;
+			return a.order < b.order;
+		});
+
+		m_vertices.resize(m_queue.size() * 12);
+		m_texCoords.resize(m_queue.size() * 8);
+		for (std::size_t q = 0; q < m_queue.size(); q++)
+		{
+			std::copy(m_queue[q].xyz, m_queue[q].xyz + 12, &m_vertices[12*q]);
+			std::copy(m_queue[q].uv, m_queue[q].uv + 8, &m_texCoords[8*q]);
+		}
+
+		glPushAttrib(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_ENABLE_BIT);
+		glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+		glEnable(GL_TEXTURE_2D);
+		glDisable(GL_DEPTH_TEST);
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		glColor3f(1.0, 1.0, 1.0);
+		glEnableClientState(GL_VERTEX_ARRAY);
+		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+		glVertexPointer(3, GL_FLOAT, 0, m_vertices.data());
+		glTexCoordPointer(2, GL_FLOAT, 0, m_texCoords.data());
+
+		std::size_t first = 0;
+		while (first < m_queue.size())
+		{
+			std::size_t end = first + 1;
+			while (end < m_queue.size()  &&  m_queue[end].texture == m_queue[first].texture)
+				end++;
+			glBindTexture(GL_TEXTURE_2D, m_queue[first].texture);
+			glDrawArrays(GL_QUADS, static_cast<GLint>(4 * first), static_cast<GLsizei>(4 * (end - first)));
+			first = end;
+		}
+
+		glPopClientAttrib();
+		glPopAttrib();
+		m_queue.clear();
+	}
+
 	~SpriteManager()
 	{
-		for (auto it = m_imageMap.begin(); it != m_imageMap.end(); it++)
-			glDeleteTextures(1, &it->second);
+		if (m_atlasTexture != 0)
+			glDeleteTextures(1, &m_atlasTexture);
 	}
 
 private:
 
+	struct QueuedSprite
+	{
+		unsigned int	layer;
+		GLuint			texture;
+		unsigned int	order;		// position in the queue, for a stable sort
+		GLfloat			xyz[12];	// the quad's corners, ready to draw
+		GLfloat			uv[8];		// and where they are in the atlas
+	};
+
+	struct AtlasFrame
+	{
+		GLuint	texture = 0;			// 0 until the frame is in the atlas
+		GLfloat	u0 = 0, v0 = 0, u1 = 0, v1 = 0;	// the frame's texels, padding excluded
+	};
+
+	struct RotatedQuad
+	{
+		double	size;
+		double	r[8];		// corners() for this size, x/y pairs in GL_QUADS order
+	};
+
+	static const int CACHED_ANGLES = 360;
+
+	  // Biggest texture the GL takes, but no more than an atlas needs
+	static unsigned int maxTextureSize()
+	{
+		GLint maxSize = 0;
+		glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+		if (maxSize <= 0)
+			maxSize = SpriteAtlas::MAX_WIDTH;
+		return std::min<unsigned int>(SpriteAtlas::MAX_WIDTH, static_cast<unsigned int>(maxSize));
+	}
+
+	void reserveImage(unsigned int imageID)
+	{
+		if (imageID >= m_frameCountPerSprite.size())
+		{
+			m_frameCountPerSprite.resize(imageID + 1, 0);
+			m_frames.resize((imageID + 1) * MAX_FRAMES_PER_SPRITE);
+		}
+	}
+
+	  // Hands the atlas and its mipmap levels (levels[0] only, if not
+	  // mipmapped) to OpenGL as they are; nothing is generated here.
+	void uploadAtlas(unsigned int width, unsigned int height, const std::vector<const unsigned char*>& levels)
+	{
+		  // Transfer Texture To OpenGL
+
+		glEnable(GL_DEPTH_TEST);
+
+		if (m_atlasTexture == 0)
+			glGenTextures(1, &m_atlasTexture);
+		glBindTexture(GL_TEXTURE_2D, m_atlasTexture);
+
+		glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+
+		if (m_mipMapped)
+		{
+			  // when texture area is small, bilinear filter the closest mipmap
+			glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+			  // when texture area is large, bilinear filter the base level (mipmaps only apply to minification)
+			glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		}
+		else
+		{
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		}
+
+		  // Frames never reach the edge of the atlas, clamping just keeps
+		  // the padding honest at the border.
+		glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, static_cast<GLfloat>(GL_CLAMP_TO_EDGE));
+		glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, static_cast<GLfloat>(GL_CLAMP_TO_EDGE));
+
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		for (std::size_t k = 0; k < levels.size(); k++)
+			glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(k), GL_RGBA,
+						 SpriteAtlas::levelSize(width, k), SpriteAtlas::levelSize(height, k), 0,
+						 GL_BGRA, GL_UNSIGNED_BYTE, levels[k]);
+	}
+
+	void placeFrame(const SpriteAtlas::Placement& placed)
+	{
+		AtlasFrame& frame = m_frames[getSpriteID(placed.imageID, placed.frameNum)];
+		frame.texture = m_atlasTexture;
+		frame.u0 = placed.u0;
+		frame.v0 = placed.v0;
+		frame.u1 = placed.u1;
+		frame.v1 = placed.v1;
+	}
+
+	  // Corners of a width x height sprite turned to angleDegrees, relative
+	  // to its center, in GL_QUADS order
+	void corners(int angleDegrees, double finalWidth, double finalHeight,
+				 double& rx1, double& ry1, double& rx2, double& ry2,
+				 double& rx3, double& ry3, double& rx4, double& ry4)
+	{
+//#define FULL_ROTATION	// for games where you can rotate 360 degrees, not just n/s/e/w
+
+#ifndef FULL_ROTATION
+		if (angleDegrees != 180)
+		{
+			rotate(-finalWidth / 2, -finalHeight / 2, angleDegrees, rx1, ry1);
+			rotate(finalWidth / 2, -finalHeight / 2, angleDegrees, rx2, ry2);
+			rotate(finalWidth / 2, finalHeight / 2, angleDegrees, rx3, ry3);
+			rotate(-finalWidth / 2, finalHeight / 2, angleDegrees, rx4, ry4);
+		}
+		else
+		{
+			// Ensure actors rotated to face left aren't upside-down.
+			rotate(-finalWidth / 2, -finalHeight / 2, 0, rx1, ry1);
+			rotate(finalWidth / 2, -finalHeight / 2, 0, rx2, ry2);
+			rotate(finalWidth / 2, finalHeight / 2, 0, rx3, ry3);
+			rotate(-finalWidth / 2, finalHeight / 2, 0, rx4, ry4);
+			std::swap(rx1, rx2);
+			std::swap(rx3, rx4);
+		}
+#else
+		angleDegrees += 90;
+		rotate(-finalWidth / 2, -finalHeight / 2, angleDegrees, rx1, ry1);
+		rotate(finalWidth / 2, -finalHeight / 2, angleDegrees, rx2, ry2);
+		rotate(finalWidth / 2, finalHeight / 2, angleDegrees, rx3, ry3);
+		rotate(-finalWidth / 2, finalHeight / 2, angleDegrees, rx4, ry4);
+#endif  // FULL_ROTATION
+	}
+
+	  // corners() for a sprite of the given size, remembered per (angle,
+	  // size).  Directions are whole degrees and sizes come from a handful
+	  // of values, so after the first few frames drawing a sprite involves
+	  // no trig at all.  Angles outside 0-359 aren't cached.
+	const double* rotatedCorners(int angleDegrees, double size)
+	{
+		RotatedQuad* quad;
+		if (angleDegrees >= 0  &&  angleDegrees < CACHED_ANGLES)
+		{
+			std::vector<RotatedQuad>& sizes = m_cornerCache[angleDegrees];
+			for (std::size_t k = 0; k < sizes.size(); k++)
+			{
+				if (sizes[k].size == size)
+					return sizes[k].r;
+			}
+			sizes.emplace_back();
+			quad = &sizes.back();
+		}
+		else
+			quad = &m_uncachedCorners;
+
+		double* r = quad->r;
+		quad->size = size;
+		corners(angleDegrees, SPRITE_WIDTH_GL * size, SPRITE_HEIGHT_GL * size,
+				r[0], r[1], r[2], r[3], r[4], r[5], r[6], r[7]);
+		return r;
+	}
+
 	void rotate(double x, double y, double degrees, double &xout, double &yout)
 	{
 		double theta = degrees*1.0 / 360 * 2 * 3.14159;
@@ -255,8 +452,16 @@ private:
 	}
 
 	bool							m_mipMapped;
-	std::map<unsigned int, GLuint>	m_imageMap;
-	std::map<unsigned int, unsigned int>		m_frameCountPerSprite;
+	std::vector<AtlasFrame>			m_frames;		// by sprite ID
+	std::vector<RotatedQuad>		m_cornerCache[CACHED_ANGLES];
+	RotatedQuad						m_uncachedCorners;
+	GLuint							m_atlasTexture;
+	std::vector<SpriteAtlas::Frame>	m_pending;		// loaded, not in the atlas yet
+	std::vector<SpriteAtlas::Frame>	m_loaded;		// in the atlas, kept in case it is rebuilt
+	std::vector<unsigned int>		m_frameCountPerSprite;	// by image ID
+	std::vector<QueuedSprite>		m_queue;
+	std::vector<GLfloat>			m_vertices;
+	std::vector<GLfloat>			m_texCoords;
 
 	static const int INVALID_SPRITE_ID = -1;
 	static const int MAX_IMAGES = 1000;
@@ -270,17 +475,14 @@ private:
 		return imageID * MAX_FRAMES_PER_SPRITE + frame;
 	}
 
-    static void makeMipmaps(unsigned char byteCount, unsigned int textureWidth, unsigned int textureHeight, char* imageData)
-    {
-        int format = (byteCount == 3 ? GL_BGR : GL_BGRA);
-#ifdef __APPLE__
-        int internalFormat = (byteCount == 3 ? GL_RGB : GL_RGBA);
-        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, textureWidth, textureHeight, 0, format, GL_UNSIGNED_BYTE, imageData);
-        glGenerateMipmap(GL_TEXTURE_2D);
-#else
-        gluBuild2DMipmaps(GL_TEXTURE_2D, byteCount, textureWidth, textureHeight, format, GL_UNSIGNED_BYTE, imageData);
-#endif
-    }
+	const AtlasFrame* findFrame(int imageID, int frame) const
+	{
+		int spriteID = getSpriteID(imageID, frame);
+		if (spriteID < 0  ||  static_cast<std::size_t>(spriteID) >= m_frames.size()  ||  m_frames[spriteID].texture == 0)
+			return nullptr;
+
+		return &m_frames[spriteID];
+	}
 };
 
 #endif // SPRITEMANAGER_H_
@@ -0,0 +1,175 @@
+#ifndef STATESTREAM_H_
+#define STATESTREAM_H_
+
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+
+  // Byte streams for world save states and replay files.  Values are
+  // written as their raw in-memory bytes (so a save state is only read back
+  // by a build for the same kind of machine), counts and tick deltas as
+  // LEB128 varints.
+
+class StateWriter
+{
+  public:
+	template <typename T>
+	void put(const T& value)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "only plain values can be written raw");
+		const unsigned char* p = reinterpret_cast<const unsigned char*>(&value);
+		m_bytes.insert(m_bytes.end(), p, p + sizeof(T));
+	}
+
+	void putBytes(const void* data, std::size_t size)
+	{
+		const unsigned char* p = static_cast<const unsigned char*>(data);
+		m_bytes.insert(m_bytes.end(), p, p + size);
+	}
+
+	  // Appends size bytes (zeroed) and returns where they start, for callers
+	  // that fill a whole block of records in place.  The pointer is only
+	  // good until the next write.
+	unsigned char* extend(std::size_t size)
+	{
+		m_bytes.resize(m_bytes.size() + size);
+		return m_bytes.data() + m_bytes.size() - size;
+	}
+
+	void reserve(std::size_t size)
+	{
+		m_bytes.reserve(size);
+	}
+
+	void putVarint(std::uint64_t value)
+	{
+		while (value >= 0x80)
+		{
+			m_bytes.push_back(static_cast<unsigned char>(value | 0x80));
+			value >>= 7;
+		}
+		m_bytes.push_back(static_cast<unsigned char>(value));
+	}
+
+	  // Pads with zero bytes up to a multiple of alignment.
+	void align(std::size_t alignment)
+	{
+		while (m_bytes.size() % alignment != 0)
+			m_bytes.push_back(0);
+	}
+
+	std::size_t size() const
+	{
+		return m_bytes.size();
+	}
+
+	const unsigned char* data() const
+	{
+		return m_bytes.data();
+	}
+
+	const std::vector<unsigned char>& bytes() const
+	{
+		return m_bytes;
+	}
+
+	void clear()
+	{
+		m_bytes.clear();
+	}
+
+  private:
+	std::vector<unsigned char> m_bytes;
+};
+
+class StateReader
+{
+  public:
+	StateReader(const unsigned char* data, std::size_t size)
+	 : m_data(data), m_size(size), m_pos(0), m_failed(false)
+	{
+	}
+
+	  // Each get returns false (and leaves failed() set) if the data runs
+	  // out, so a caller can read a whole record and check once at the end.
+	template <typename T>
+	bool get(T& value)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "only plain values can be read raw");
+		if (m_failed  ||  m_size - m_pos < sizeof(T))
+		{
+			m_failed = true;
+			return false;
+		}
+		std::memcpy(&value, m_data + m_pos, sizeof(T));
+		m_pos += sizeof(T);
+		return true;
+	}
+
+	  // The next size bytes, read in place, or nullptr if there aren't that many
+	const unsigned char* getBytes(std::size_t size)
+	{
+		if (m_failed  ||  m_size - m_pos < size)
+		{
+			m_failed = true;
+			return nullptr;
+		}
+		const unsigned char* p = m_data + m_pos;
+		m_pos += size;
+		return p;
+	}
+
+	bool getVarint(std::uint64_t& value)
+	{
+		value = 0;
+		for (int shift = 0; shift < 64; shift += 7)
+		{
+			if (m_failed  ||  m_pos == m_size)
+				break;
+			unsigned char byte = m_data[m_pos++];
+			value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+			if ((byte & 0x80) == 0)
+				return true;
+		}
+		m_failed = true;
+		return false;
+	}
+
+	bool failed() const
+	{
+		return m_failed;
+	}
+
+	std::size_t position() const
+	{
+		return m_pos;
+	}
+
+	bool atEnd() const
+	{
+		return m_pos == m_size;
+	}
+
+  private:
+	const unsigned char*	m_data;
+	std::size_t				m_size;
+	std::size_t				m_pos;
+	bool					m_failed;
+};
+
+  // FNV-1a over size bytes: equal save states give equal checksums, and a
+  // damaged one almost certainly doesn't
+inline std::uint64_t stateChecksum(const unsigned char* data, std::size_t size)
+{
+	std::uint64_t hash = 14695981039346656037ULL;
+	for (std::size_t k = 0; k < size; k++)
+	{
+		hash ^= data[k];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+#endif // STATESTREAM_H_
@@ -3,11 +3,12 @@
 #include <string>
 
 #include "Actor.h"              //for Actor operations
+#include "ActorRules.h"         //for running the actors' rules on rows
+#include "StateStream.h"        //for save states
 #include <cmath>                //for sin and cos operations etc.
+#include <cstring>              //for std::memcpy
 #include <vector>               //for holding actors in one container and using vector operations
-#include <unordered_set>        //for cab generation randomizing (random lane choice)
 #include <iostream>             //for << operator
-#include <sstream>              //for std::ostringstream
 #include <algorithm>            //for std::min and std::max
 
 using namespace std;
@@ -18,7 +19,7 @@ GameWorld* createStudentWorld(string assetPath)
 }
 
 StudentWorld::StudentWorld(string assetPath)
-: GameWorld(assetPath)
+: GameWorld(assetPath), m_arena(ACTOR_SLOT_SIZE), m_storageMode(OBJECT_STORAGE)
 {
     m_racer = nullptr;                  //initialize racer pointer to nullptr so that we don't have bad access if exiting game w/o starting
     m_souls2Save = 0;                   //initialize integer/double member values that will be set up properly at each init()
@@ -28,36 +29,34 @@ StudentWorld::StudentWorld(string assetPath)
 
 int StudentWorld::init()
 {
+    GraphObjectRegistry::Scope display(graphObjects());     //actors built during init are displayed by this world (not whichever other world shares the thread)
+    
     //initialize basic data structures to keep track of level
     m_souls2Save = 2 * getLevel() + 5;
     m_bonusPoints = 5000;
     
     //insert ghost racer into the world
-    m_racer = new GhostRacer( this );
+    m_racer = makeActor<GhostRacer>( this );
     
     //initialize road lines:
     
     //initialize left yellow borders
     for (int N = 0; N < VIEW_HEIGHT/SPRITE_HEIGHT; N++){
-        Actor* newYellowBorder = new BorderLine(IID_YELLOW_BORDER_LINE, LEFT_EDGE, N * SPRITE_HEIGHT, this);
-        m_actors.push_back(newYellowBorder);
+        addNewActor<BorderLine>(IID_YELLOW_BORDER_LINE, LEFT_EDGE, N * SPRITE_HEIGHT, this);
     }
     //right yellow borders
     for (int N = 0; N < VIEW_HEIGHT/SPRITE_HEIGHT; N++){
-        Actor* newYellowBorder = new BorderLine(IID_YELLOW_BORDER_LINE, RIGHT_EDGE, N * SPRITE_HEIGHT, this);
-        m_actors.push_back(newYellowBorder);
+        addNewActor<BorderLine>(IID_YELLOW_BORDER_LINE, RIGHT_EDGE, N * SPRITE_HEIGHT, this);
     }
     //left white borders
     for (int M = 0; M < VIEW_HEIGHT/ (4*SPRITE_HEIGHT); M++){
-        Actor* newWhiteBorder = new BorderLine(IID_WHITE_BORDER_LINE, LEFT_EDGE + ROAD_WIDTH/3, M * 4*SPRITE_HEIGHT, this);
-        m_actors.push_back(newWhiteBorder);
-        m_highestWhiteBorder = newWhiteBorder->getY();
+        addNewActor<BorderLine>(IID_WHITE_BORDER_LINE, LEFT_EDGE + ROAD_WIDTH/3, M * 4*SPRITE_HEIGHT, this);
+        m_highestWhiteBorder = M * 4*SPRITE_HEIGHT;
     }
     //right white borders
     for (int M = 0; M < VIEW_HEIGHT/ (4*SPRITE_HEIGHT); M++){
-        Actor* newWhiteBorder = new BorderLine(IID_WHITE_BORDER_LINE, RIGHT_EDGE - ROAD_WIDTH/3, M * 4*SPRITE_HEIGHT, this);
-        m_actors.push_back(newWhiteBorder);
-        m_highestWhiteBorder = newWhiteBorder->getY();
+        addNewActor<BorderLine>(IID_WHITE_BORDER_LINE, RIGHT_EDGE - ROAD_WIDTH/3, M * 4*SPRITE_HEIGHT, this);
+        m_highestWhiteBorder = M * 4*SPRITE_HEIGHT;
     }
     
     return GWSTATUS_CONTINUE_GAME;
@@ -65,6 +64,8 @@ int StudentWorld::init()
 
 int StudentWorld::move()
 {
+    GraphObjectRegistry::Scope display(graphObjects());     //same for actors spawned this tick
+    
     //MARK:GIVE EACH ACTOR A CHANCE TO DO SOMETHING
     if ( m_racer->isAlive() ){          //Ghost Racer gets a chance to do something
         m_racer->doSomething();
@@ -74,14 +75,22 @@ int StudentWorld::move()
         }
     }
     //rest of the actors
-    for (int i = 0; i < m_actors.size(); i++ ){
-        if ( m_actors[i]->isAlive() )
-            m_actors[i]->doSomething();
-        if ( !m_racer-> isAlive() ){
+    if (m_storageMode == COLUMN_STORAGE){
+        if ( !moveRows() ){
             decLives();
             return GWSTATUS_PLAYER_DIED;
         }
     }
+    else{
+        for (int i = 0; i < m_actors.size(); i++ ){
+            if ( m_actors[i]->isAlive() )
+                m_actors[i]->doSomething();
+            if ( !m_racer-> isAlive() ){
+                decLives();
+                return GWSTATUS_PLAYER_DIED;
+            }
+        }
+    }
     //check if done with level
     if (m_souls2Save <= 0){
         increaseScore(m_bonusPoints);
@@ -93,15 +102,21 @@ int StudentWorld::move()
     m_highestWhiteBorder -= (4 + getRacerSpeed());  //border lines move at speed -4 - the racer's speed
     
     //REMOVE DEAD OBJECTS
-    for (int i = 0; i < m_actors.size(); ){
-        if ( !m_actors[i]->isAlive() ){
-            vector<Actor*>::iterator deleterIt = m_actors.begin() + i;
-            delete *deleterIt;
-            m_actors.erase(deleterIt);
+    //one compaction pass: survivors slide down in their original order (so update order stays the same) and the dead are deleted as we pass them
+    m_columns.removeDeadRows();
+    vector<Actor*>::iterator keepIt = m_actors.begin();
+    for (vector<Actor*>::iterator it = m_actors.begin(); it != m_actors.end(); it++){
+        if ( (*it)->isAlive() ){
+            *keepIt = *it;
+            keepIt++;
+        }
+        else{
+            if ((*it)->isCollisionAvoidanceWorthy())
+                m_laneIndex.erase(laneBucket((*it)->getX()), (*it)->getY(), *it);
+            destroyActor(*it);                  //also takes it off the display list
         }
-        else
-            i++;
     }
+    m_actors.erase(keepIt, m_actors.end());     //only trims the tail, nothing left to shift
     
     //MARK:POTENTIALLY ADD NEW ACTORS:
     //add borderlines
@@ -121,9 +136,14 @@ int StudentWorld::move()
     
     //MARK:Update the Game Status Line
     //Update display text // update the score/lives/level text at screen top
-    gameStats << "Score: " << getScore() << "  Lvl: " << getLevel() << "  Souls2Save: " << m_souls2Save <<  "  Lives: " << getLives() << "  Health: " << m_racer->getHP() << "  Sprays: " << m_racer->getAmmo() << "  Bonus: " << m_bonusPoints;
-    setGameStatText(gameStats.str());
-    gameStats.str("");      //clear the stringstream after displaying
+    //only the numbers are handed over here, the controller builds the text if and when it draws a frame
+    setStatusField(0, "Score", getScore());
+    setStatusField(1, "Lvl", getLevel());
+    setStatusField(2, "Souls2Save", m_souls2Save);
+    setStatusField(3, "Lives", getLives());
+    setStatusField(4, "Health", m_racer->getHP());
+    setStatusField(5, "Sprays", m_racer->getAmmo());
+    setStatusField(6, "Bonus", m_bonusPoints);
     
     //increment bonus points -1 each tick
     m_bonusPoints--;
@@ -135,15 +155,139 @@ int StudentWorld::move()
 
 void StudentWorld::cleanUp()
 {
-    vector<Actor*>::iterator deleterIt = m_actors.begin();
-    while (!m_actors.empty()){
-        delete *deleterIt;
-        deleterIt = m_actors.erase(deleterIt);
+    graphObjects().clear();                 //deregister the whole level from the display in one go
+    m_actors.clear();
+    m_laneIndex.clear();
+    m_columns.clear();
+    m_racer = nullptr;                      //racer lives in the arena too
+    m_arena.reset();                        //every actor (and the racer) was built in the arena, so this releases the whole level at once. capacity is kept for the next level
+}
+
+bool StudentWorld::setStorageMode(const StorageMode& mode){
+    if (m_racer != nullptr)
+        return false;                       //a running level's actors stay where they are
+    m_storageMode = mode;
+    return true;
+}
+StudentWorld::StorageMode StudentWorld::getStorageMode() const{
+    return m_storageMode;
+}
+
+void StudentWorld::destroyActor(Actor* a){
+    void* slot = dynamic_cast<void*>(a);    //start of the most derived object, which is where makeActor put it
+    a->~Actor();
+    m_arena.release(slot);
+}
+
+//***********************************************************************************************
+//SAVE STATES
+//***********************************************************************************************
+//actor records are written raw (ActorState has no hidden padding), the live ones as one block so a save is a
+//straight copy and a restore reads them in place without going through the stream a field at a time
+static_assert(sizeof(ActorState) == 72, "ActorState changed, check it still has no hidden padding");
+
+void StudentWorld::saveWorld(StateWriter& out) const{
+    unsigned char levelRunning = (m_racer != nullptr);
+    out.put(levelRunning);
+    if (!levelRunning)
+        return;                                     //between levels there's nothing but GameWorld's counters
+    out.put(m_souls2Save);
+    out.put(m_bonusPoints);
+    out.put(m_highestWhiteBorder);
+    
+    ActorState state;
+    m_racer->saveState(state);
+    out.put(state);
+    
+    //only live actors: the dead are inert and would be removed before anything looked at them again
+    //rows save to the same records their objects would, so either storage mode restores the other's saves
+    std::uint32_t numLive = 0;
+    for (size_t i = 0; i < m_actors.size(); i++)
+        numLive += m_actors[i]->isAlive();
+    for (size_t i = 0; i < m_columns.rows(); i++)
+        numLive += m_columns.alive[i];
+    out.put(numLive);
+    unsigned char* block = out.extend(numLive * sizeof(ActorState));
+    for (size_t i = 0; i < m_actors.size(); i++){
+        if ( !m_actors[i]->isAlive() )
+            continue;
+        m_actors[i]->saveState(state);
+        std::memcpy(block, &state, sizeof(ActorState));
+        block += sizeof(ActorState);
+    }
+    for (size_t i = 0; i < m_columns.rows(); i++){
+        if ( !m_columns.alive[i] )
+            continue;
+        m_columns.saveRow(i, state);
+        std::memcpy(block, &state, sizeof(ActorState));
+        block += sizeof(ActorState);
+    }
+}
+
+bool StudentWorld::restoreWorld(StateReader& in){
+    cleanUp();                                      //whatever level was running goes, the save state brings its own
+    GraphObjectRegistry::Scope display(graphObjects());
+    
+    unsigned char levelRunning = 0;
+    if (!in.get(levelRunning))
+        return false;
+    if (!levelRunning)
+        return true;
+    in.get(m_souls2Save);
+    in.get(m_bonusPoints);
+    in.get(m_highestWhiteBorder);
+    
+    ActorState state;
+    if (!in.get(state) || state.kind != KIND_GHOST_RACER)
+        return false;
+    m_racer = makeActor<GhostRacer>( this );
+    m_racer->restoreState(state);
+    
+    std::uint32_t numActors = 0;
+    const unsigned char* block = nullptr;
+    if (in.get(numActors))
+        block = in.getBytes(numActors * sizeof(ActorState));
+    if (block == nullptr){
+        cleanUp();
+        return false;
+    }
+    m_actors.reserve(numActors);
+    for (std::uint32_t i = 0; i < numActors; i++){
+        std::memcpy(&state, block + i * sizeof(ActorState), sizeof(ActorState));
+        if (m_storageMode == COLUMN_STORAGE){
+            if (state.kind == KIND_GHOST_RACER || state.kind >= NUM_ACTOR_KINDS){
+                cleanUp();                          //same kinds makeActorFromState refuses
+                return false;
+            }
+            m_columns.appendRow(state);
+            continue;
+        }
+        Actor* a = makeActorFromState(state);
+        if (a == nullptr){
+            cleanUp();                              //bad data, leave no half-built level behind
+            return false;
+        }
+        a->restoreState(state);                     //before addActor, so the lane index sees where it really is
+        addActor(a);
     }
-    if ( m_racer != nullptr )
-        delete m_racer;
+    return true;
 }
 
+Actor* StudentWorld::makeActorFromState(const ActorState& state){
+    switch (state.kind)
+    {
+        case KIND_HUMAN_PED:            return makeActor<HumanPedestrian>(state.x, state.y, this);
+        case KIND_ZOMBIE_PED:           return makeActor<ZombiePedestrian>(state.x, state.y, this);
+        case KIND_ZOMBIE_CAB:           return makeActor<ZombieCab>(state.x, state.y, state.vertSpeed, this);
+        case KIND_HOLY_WATER_PROJECTILE:return makeActor<HolyWaterProjectile>(state.x, state.y, state.direction, this);
+        case KIND_BORDER_LINE:          return makeActor<BorderLine>(state.imageID, state.x, state.y, this);
+        case KIND_OIL_SLICK:            return makeActor<OilSlick>(state.x, state.y, this);            //draws a size, GameWorld puts the generator back afterwards
+        case KIND_HEALING_GOODIE:       return makeActor<HealingGoodie>(state.x, state.y, this);
+        case KIND_HOLY_WATER_GOODIE:    return makeActor<HolyWaterGoodie>(state.x, state.y, this);
+        case KIND_SOUL_GOODIE:          return makeActor<SoulGoodie>(state.x, state.y, this);
+        default:                        return nullptr;                                               //GRacer is saved separately, anything else is garbage
+    }
+}
 
 //***********************************************************************************************
 //RACER GETTERS
@@ -163,6 +307,9 @@ double StudentWorld::getRacerY() const{
 bool StudentWorld::racerIsAlive() const{
     return m_racer->isAlive();
 }
+int StudentWorld::getRacerHP() const{
+    return m_racer->getHP();
+}
 //***********************************************************************************************
 //RACER SETTERS
 //***********************************************************************************************
@@ -197,6 +344,8 @@ void StudentWorld::giveRacerAmmo(const int& amt){
 //***********************************************************************************************
 void StudentWorld::addActor(Actor* a){
     m_actors.push_back(a);
+    if (a->isCollisionAvoidanceWorthy())
+        m_laneIndex.insert(laneBucket(a->getX()), a->getY(), a);     //CAW actors also go into the lane index so cabs can find their neighbors quickly
 }
 void StudentWorld::saveASoul(){
     m_souls2Save --;
@@ -205,31 +354,33 @@ void StudentWorld::saveASoul(){
 //***********************************************************************************************
 //OTHER PUBLIC HELPERS/OTHER METHODS
 //***********************************************************************************************
-bool StudentWorld::overlapWithRacer(const Actor* a) const{ 
-    if (theyOverlap(a, m_racer))
-        return true;
-    return false;
-}
-void StudentWorld::closestCAWActorsInLane(const Actor* a, double& pixelsFront, double& pixelsBack) const{       //finds closest CAW actors in lane that are still alive and should be avoided
-    int actorALane = getActorLane(a);   //get the actors lane
+void StudentWorld::closestCAWActorsInLane(const double& x, const double& y, double& pixelsFront, double& pixelsBack) const{       //finds closest CAW actors in lane that are still alive and should be avoided
+    int bucket = laneBucket(x);
+    double foundY = 0;
     pixelsFront = VIEW_HEIGHT;          //reset these to max pixels, this will be the default if we don't find any actors in the lane in front or behind
     pixelsBack = -VIEW_HEIGHT;
     
-    for (int i = 0; i < m_actors.size(); i++){
-        if ( m_actors[i]->isCollisionAvoidanceWorthy() && m_actors[i]->isAlive() && m_actors[i]!=a){  //MARK: Added check for aliasing
-            if (getActorLane(m_actors[i]) == actorALane){
-                double pixelsBetween = m_actors[i]->getY() - a->getY();
-                if ( pixelsBetween > 0 && pixelsBetween < pixelsFront )
-                    pixelsFront = pixelsBetween;
-                else if ( pixelsBetween < 0 && pixelsBetween > pixelsBack )
-                    pixelsBack = pixelsBetween;
-            }
+    if (m_storageMode == COLUMN_STORAGE){
+        for (size_t i = 0; i < m_columns.rows(); i++){
+            if ( !rowIsCAWInLane(i, bucket) )
+                continue;
+            if (m_columns.y[i] > y)
+                pixelsFront = min(pixelsFront, m_columns.y[i] - y);
+            else if (m_columns.y[i] < y)
+                pixelsBack = max(pixelsBack, m_columns.y[i] - y);
         }
+        return;
     }
-}
-bool StudentWorld::projectileMaybeDamageActor(const Actor* projectile) const{
+    //first live actor strictly above y is the closest one in front (equal y doesn't count, just like a zero pixel gap never did)
+    if (m_laneIndex.firstAbove(bucket, y, foundY))
+        pixelsFront = min(pixelsFront, foundY - y);
+    //last live actor strictly below y is the closest one behind
+    if (m_laneIndex.lastBelow(bucket, y, foundY))
+        pixelsBack = max(pixelsBack, foundY - y);
+}
+bool StudentWorld::projectileMaybeDamageActor(const Actor& projectile) const{
     for (int i = 0; i< m_actors.size(); i++){
-        if (theyOverlap(projectile, m_actors[i]) && m_actors[i]!= projectile && m_actors[i]->isAffectedByProjectiles() && m_actors[i]->isAlive()){
+        if (theyOverlap(projectile, *m_actors[i]) && m_actors[i]!= &projectile && m_actors[i]->isAffectedByProjectiles() && m_actors[i]->isAlive()){
             m_actors[i]->hitByProjectile(1);            //projectile attempts to damage actor by 1. This method may cause instant death for relevant goodies, reverse a human ped, or damage zombie enemies
             return true;        //we hit an actor that could be damaged via projectile (AND WAS ALIVE), return true immediately don't damage multiple. This true tells the projectile to mark itself for death
         }
@@ -240,29 +391,18 @@ bool StudentWorld::projectileMaybeDamageActor(const Actor* projectile) const{
 //***********************************************************************************************
 //PRIVATE HELPERS
 //***********************************************************************************************
-bool StudentWorld::theyOverlap(const Actor* a, const Actor* b) const{
-    double delta_x = std::abs( a->getX() - b->getX() );
-    double delta_y = std::abs( a->getY() - b->getY() );
-    int radius_sum = a->getRadius() + b->getRadius();
-    if (delta_x < radius_sum* 0.25 && delta_y < radius_sum * 0.6)           //if condition is met, two actors are said to overlap
-        return true;
-    return false;                                                           //otherwise return false
-}
-
 bool StudentWorld::findSafePlaceForCab(int& chosenLane, double& startY, double& startSpeed){
-    //generate a random unordered set of lanes to check
-    std::unordered_set<int> laneChecker;    //hold the lanes to check (in random order)
+    //generate a random order of lanes to check
+    int firstPick = randInt(1,3);           //left lane is defied lane 1, middle is lane 2, right is lane 3. randomly pick the first two lanes
+    int secondPick = firstPick;
+    while (secondPick == firstPick)
+        secondPick = randInt(1,3);
+    //check the lane that wasn't picked first, then the two picks in reverse (a fixed order, the same on every platform; the old unordered_set version visited them in whatever order the standard library's hashing gave, and allocated every tick)
+    const int laneOrder[3] = { 6 - firstPick - secondPick, secondPick, firstPick };
     int cur_lane = -1;  //vars for checking lanes and also the initialization of zombie cab
-    while (laneChecker.size() < 2)
-        laneChecker.insert(randInt(1,3));   //left lane is defied lane 1, middle is lane 2, right is lane 3. randomly add the first two lanes
-    for (int finalAdd = 1; laneChecker.size() < 3; finalAdd++)
-        laneChecker.insert(finalAdd);       //add whatever lane wasn't in there yet (saves time and still completely random since third in the set's prob is defined by the inclusion of the other two lanes)
     //now check each lane for a safe spot
-    while (laneChecker.size() > 0){
-        std::unordered_set<int>::iterator it;
-        it = laneChecker.begin();
-        cur_lane = *it;                 //get the random lane
-        it = laneChecker.erase(it);     //and remove it from the set
+    for (int i = 0; i < 3; i++){
+        cur_lane = laneOrder[i];        //get the random lane
         //determine closes CAW actor to bottom of screen in candidate lane
         double lowestY = lowestCAWActorInLane(cur_lane); //MARK: return val of this func implictly checks whether any actor in the lane at all for the sake of the below if statement.
         if (lowestY > VIEW_HEIGHT / 3){
@@ -286,53 +426,77 @@ bool StudentWorld::findSafePlaceForCab(int& chosenLane, double& startY, double&
 }
 
 int StudentWorld::getActorLane(const Actor* a) const{               //gets the lane a given actor falls in (>= left of lane, < right of lane per spec)
+    return getLane(a->getX());
+}
+
+int StudentWorld::getLane(const double& x) const{                   //lane for an x coordinate, -1 if off the road
     int laneNumber = -1;
-    if (a->getX() >= LEFT_EDGE && a->getX() < LEFT_EDGE + ROAD_WIDTH/3)
+    if (x >= LEFT_EDGE && x < LEFT_EDGE + ROAD_WIDTH/3)
         laneNumber = 1;
-    else if (a->getX() >= LEFT_EDGE + ROAD_WIDTH/3 && a->getX() < RIGHT_EDGE - ROAD_WIDTH/3)
+    else if (x >= LEFT_EDGE + ROAD_WIDTH/3 && x < RIGHT_EDGE - ROAD_WIDTH/3)
         laneNumber = 2;
-    else if (a->getX() >= RIGHT_EDGE - ROAD_WIDTH/3 && a->getX() < RIGHT_EDGE)
+    else if (x >= RIGHT_EDGE - ROAD_WIDTH/3 && x < RIGHT_EDGE)
         laneNumber = 3;
     return laneNumber;
 }
 
+int StudentWorld::laneBucket(const double& x) const{                //off-road actors get bucket 0, lanes 1-3 get their own bucket
+    int laneNumber = getLane(x);
+    return (laneNumber == -1 ? 0 : laneNumber);
+}
+
 double StudentWorld::lowestCAWActorInLane(const int& laneNumber){       //finds y location of lowest alive CAW actor in the lane given
     double lowestY = VIEW_HEIGHT + 1;              //default of VIEW_HEIGHT + 1 if no actor in lane
-    for (int i = 0; i < m_actors.size(); i++){
-        if (getActorLane(m_actors[i]) == laneNumber && m_actors[i]->isAlive() && m_actors[i]->isCollisionAvoidanceWorthy() && m_actors[i]->getY() < lowestY )
-            lowestY = m_actors[i]->getY();
+    double foundY = 0;
+    if (m_storageMode == COLUMN_STORAGE){
+        for (size_t i = 0; i < m_columns.rows(); i++){
+            if ( rowIsCAWInLane(i, laneNumber) )
+                lowestY = min(lowestY, m_columns.y[i]);
+        }
     }
+    else if (m_laneIndex.lowest(laneNumber, foundY))     //lane is sorted by y so the first live one is the lowest
+        lowestY = min(lowestY, foundY);
     //also check ghost racer even tho she's not in the vector
     return std::min(getRacerY(), lowestY);                     //returns VIEW_HEIGHT + 1 if no CAW Actors found, otherwise returns y value of lowest CAW actor in the lane (INCL. Ghost Racer)
 }
 
 double StudentWorld::highestCAWActorInLane(const int& laneNumber){      //finds y location of highest CAW actor in the lane given
     double highestY = -1;              //default of -1 if no actor in lane
-    for (int i = 0; i < m_actors.size(); i++){
-        if (getActorLane(m_actors[i]) == laneNumber && m_actors[i]->isAlive() && m_actors[i]->isCollisionAvoidanceWorthy() && m_actors[i]->getY() > highestY )
-            highestY = m_actors[i]->getY();
+    double foundY = 0;
+    if (m_storageMode == COLUMN_STORAGE){
+        for (size_t i = 0; i < m_columns.rows(); i++){
+            if ( rowIsCAWInLane(i, laneNumber) )
+                highestY = max(highestY, m_columns.y[i]);
+        }
     }
+    else if (m_laneIndex.highest(laneNumber, foundY))    //and the last live one is the highest
+        highestY = max(highestY, foundY);
     //also check ghost racer even tho she's not in the vector
     return std::max(getRacerY(), highestY);                     //returns VIEW_HEIGHT + 1 if no CAW Actors found, otherwise returns y value of lowest CAW actor in the lane INCL. GHOST RACER
 }
 
+//***********************************************************************************************
+//LANE INDEX
+//***********************************************************************************************
+void StudentWorld::caWorthyActorMoved(Actor* a, const double& oldX, const double& oldY){        //keeps the lane index in step with a CAW actor that just moved
+    if (a == m_racer)
+        return;                                     //racer is never in the index (queries add her in separately)
+    m_laneIndex.move(laneBucket(oldX), oldY, laneBucket(a->getX()), a->getY(), a);
+}
+
 void StudentWorld::addBorderLines(){
     //add border lines:
     double new_border_y = VIEW_HEIGHT - SPRITE_HEIGHT;
     double delta_y = new_border_y - m_highestWhiteBorder;
     if ( delta_y >= SPRITE_HEIGHT ){
         //need to add yellow borders
-        Actor* newLeftYellowBorder = new BorderLine(IID_YELLOW_BORDER_LINE, LEFT_EDGE, new_border_y, this);
-        Actor* newRightYellowBorder = new BorderLine(IID_YELLOW_BORDER_LINE, RIGHT_EDGE, new_border_y, this);
-        m_actors.push_back(newLeftYellowBorder);
-        m_actors.push_back(newRightYellowBorder);
+        addNewActor<BorderLine>(IID_YELLOW_BORDER_LINE, LEFT_EDGE, new_border_y, this);
+        addNewActor<BorderLine>(IID_YELLOW_BORDER_LINE, RIGHT_EDGE, new_border_y, this);
     }
     if ( delta_y >= 4*SPRITE_HEIGHT ){
-        Actor* newLeftWhiteBorder = new BorderLine(IID_WHITE_BORDER_LINE, LEFT_EDGE + ROAD_WIDTH/3, new_border_y, this);
-        Actor* newRightWhiteBorder = new BorderLine(IID_WHITE_BORDER_LINE, RIGHT_EDGE - ROAD_WIDTH/3, new_border_y, this);
-        m_actors.push_back(newLeftWhiteBorder);
-        m_actors.push_back(newRightWhiteBorder);
-        m_highestWhiteBorder = newLeftWhiteBorder->getY();
+        addNewActor<BorderLine>(IID_WHITE_BORDER_LINE, LEFT_EDGE + ROAD_WIDTH/3, new_border_y, this);
+        addNewActor<BorderLine>(IID_WHITE_BORDER_LINE, RIGHT_EDGE - ROAD_WIDTH/3, new_border_y, this);
+        m_highestWhiteBorder = new_border_y;
     }
 }
 void StudentWorld::addZombieCabs(){
@@ -360,8 +524,7 @@ void StudentWorld::addZombieCabs(){
                     break;
                 }
             }
-            Actor* newZombieCab = new ZombieCab(startX, startY, startSpeed, this);
-            m_actors.push_back(newZombieCab);
+            addNewActor<ZombieCab>(startX, startY, startSpeed, this);
         }
         //otherwise, we didn't find a safe place for the cab to start, so we won't add one this tick
     }
@@ -369,8 +532,7 @@ void StudentWorld::addZombieCabs(){
 void StudentWorld::addOilSlicks(){
     int ChanceOilSlick = std::max(150 - getLevel() * 10, 40);
     if (randInt(0, ChanceOilSlick -1) == 0){
-        Actor* newOilSlick = new OilSlick(randInt(ROAD_CENTER - ROAD_WIDTH /2, ROAD_CENTER + ROAD_WIDTH/2), VIEW_HEIGHT, this);
-        m_actors.push_back(newOilSlick);
+        addNewActor<OilSlick>(randInt(ROAD_CENTER - ROAD_WIDTH /2, ROAD_CENTER + ROAD_WIDTH/2), VIEW_HEIGHT, this);
     }
 }
 void StudentWorld::addZombiePeds(){
@@ -378,8 +540,7 @@ void StudentWorld::addZombiePeds(){
     if (randInt(0, ChanceZombiePed - 1) == 0){
         double xPlacement = randInt(0, VIEW_WIDTH-1);  //MARK: Fixed to this after talking with profs, technically unclear in spec
         double yPlacement = VIEW_HEIGHT;
-        Actor* newHumanPed = new ZombiePedestrian(xPlacement, yPlacement, this);
-        m_actors.push_back(newHumanPed);
+        addNewActor<ZombiePedestrian>(xPlacement, yPlacement, this);
     }
 }
 void StudentWorld::addHumanPeds(){
@@ -387,22 +548,52 @@ void StudentWorld::addHumanPeds(){
     if (randInt(0, ChanceHumanPed - 1) == 0 ){
         int xPlacement = randInt(0, VIEW_WIDTH-1);      //MARK: Fixed to this after talking with profs, technically unclear in spec
         int yPlacement = VIEW_HEIGHT;
-        Actor* newHumanPed = new HumanPedestrian(xPlacement, yPlacement, this);
-        m_actors.push_back(newHumanPed);
+        addNewActor<HumanPedestrian>(xPlacement, yPlacement, this);
     }
 }
 void StudentWorld::addHolyWaterGoodies(){
     int ChanceOfHolyWater = 100 + 10 * getLevel();
     if (randInt(0, ChanceOfHolyWater - 1) == 0){
-        Actor* newHWGoodie = new HolyWaterGoodie(randInt(ROAD_CENTER - ROAD_WIDTH /2, ROAD_CENTER + ROAD_WIDTH/2), VIEW_HEIGHT, this);
-        m_actors.push_back(newHWGoodie);
+        addNewActor<HolyWaterGoodie>(randInt(ROAD_CENTER - ROAD_WIDTH /2, ROAD_CENTER + ROAD_WIDTH/2), VIEW_HEIGHT, this);
     }
 }
 void StudentWorld::addSoulGoodies(){
     int ChanceOfLostSoul = 100;
     if (randInt(0, ChanceOfLostSoul -1) == 0){
-        Actor* newLostSoul = new SoulGoodie(randInt(ROAD_CENTER - ROAD_WIDTH /2, ROAD_CENTER + ROAD_WIDTH/2), VIEW_HEIGHT, this);
-        m_actors.push_back(newLostSoul);
+        addNewActor<SoulGoodie>(randInt(ROAD_CENTER - ROAD_WIDTH /2, ROAD_CENTER + ROAD_WIDTH/2), VIEW_HEIGHT, this);
+    }
+}
+
+//***********************************************************************************************
+//COLUMN STORAGE
+//***********************************************************************************************
+void StudentWorld::addRow(const Actor& made){
+    ActorState state;
+    made.saveState(state);
+    m_columns.appendRow(state);
+}
+
+bool StudentWorld::moveRows(){
+    for (size_t i = 0; i < m_columns.rows(); i++){                      //rows added during the tick get their turn too, just like actors added to m_actors
+        if ( m_columns.alive[i] )
+            visitActorRow(m_columns, i, this, [](auto row){ row.actuallyDoSomething(); });      //the update kernel for the row's kind
+        if ( !m_racer->isAlive() )
+            return false;
+    }
+    return true;
+}
+
+bool StudentWorld::projectileMaybeDamageActor(const ActorRow& projectile){
+    for (size_t i = 0; i < m_columns.rows(); i++){
+        ActorRow other(m_columns, i, this);
+        if (theyOverlap(projectile, other) && i != projectile.getRow() && kindIsAffectedByProjectiles(static_cast<ActorKind>(m_columns.kind[i])) && m_columns.alive[i]){
+            visitActorRow(m_columns, i, this, [](auto row){ row.hitByProjectile(1); });
+            return true;
+        }
     }
+    return false;
 }
 
+bool StudentWorld::rowIsCAWInLane(const size_t& row, const int& bucket) const{
+    return m_columns.alive[row] && kindIsCollisionAvoidanceWorthy(static_cast<ActorKind>(m_columns.kind[row])) && laneBucket(m_columns.x[row]) == bucket;
+}
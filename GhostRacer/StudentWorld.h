@@ -4,13 +4,19 @@
 #include "GameWorld.h"
 #include <string>
 
+#include "ActorArena.h" //level-scoped storage every actor is built in
+#include "ActorColumns.h" //column (structure-of-arrays) actor storage
+#include "LaneIndex.h"  //per-lane y-sorted index of CAW actors
 #include <vector>       //for vector container to actors
-#include <sstream>      //for stringstream member tracking game data
+#include <new>          //for placement new into the arena
+#include <utility>      //for std::forward
+#include <cmath>        //for std::abs
 
 
 
 class Actor;
 class GhostRacer;
+struct ActorState;
 
 class StudentWorld : public GameWorld
 {
@@ -18,6 +24,13 @@ public:
     //StudentWorld constants
     const int LEFT_EDGE = ROAD_CENTER - ROAD_WIDTH/2;
     const int RIGHT_EDGE = ROAD_CENTER + ROAD_WIDTH/2;
+    static constexpr std::size_t ACTOR_SLOT_SIZE = 192;                 //arena slot size, big enough for any Actor subclass (checked when one is made)
+    
+    //how the world keeps every actor but GRacer. Both play exactly the same game (the same rules, RNG calls in the same order)
+    enum StorageMode{
+        OBJECT_STORAGE,                                                 //an Actor object each, updated through its virtual doSomething (the default)
+        COLUMN_STORAGE                                                  //a row each of ActorColumns, updated by the kernel for its kind. Rows aren't GraphObjects, so only GRacer gets drawn: for worlds nothing draws (headless runs, lookahead copies)
+    };
     
     //MAIN METHODS:
     StudentWorld(std::string assetPath);
@@ -28,12 +41,16 @@ public:
     virtual int move();
     virtual void cleanUp();
     
+    bool setStorageMode(const StorageMode& mode);                       //only between levels (returns false and changes nothing while a level is running)
+    StorageMode getStorageMode() const;
+    
     //public getters to learn about Ghost Racer:
     double getRacerSpeed() const;
     int getRacerDirection() const;
     double getRacerX() const;
     double getRacerY() const;
     bool racerIsAlive() const;
+    int getRacerHP() const;
     
     //public setters to affect the GhostRacer:
     void killRacer();
@@ -46,23 +63,66 @@ public:
     void saveASoul();
     void addActor(Actor* a);                                            //allows actors to add another actor to the world
     
+    //builds a new actor in the world's arena (not added to the world yet, use addActor for that). The world frees it when it dies or the level ends, never delete it
+    template <typename T, typename... Args>
+    T* makeActor(Args&&... args){
+        static_assert(sizeof(T) <= ACTOR_SLOT_SIZE, "Actor subclass no longer fits in an arena slot, raise ACTOR_SLOT_SIZE");
+        return new (m_arena.allocate()) T(std::forward<Args>(args)...);
+    }
+    
+    //makes a new T and adds it to the world, as an object or a row depending on the storage mode
+    template <typename T, typename... Args>
+    void addNewActor(Args&&... args){
+        if (m_storageMode == COLUMN_STORAGE){
+            T made(std::forward<Args>(args)...);                        //only read for its starting state, the row is the actor from here on
+            addRow(made);
+        }
+        else
+            addActor(makeActor<T>(std::forward<Args>(args)...));
+    }
+    
     //Public helpers/ other methods
-    bool overlapWithRacer(const Actor* a) const;                                                //allows actors to determine whether they overlap with the racer
-    void closestCAWActorsInLane(const Actor* a, double& pixelsFront, double& pixelsBack) const;       //finds the closest live CAW actors in front or behind the given actor (in the same lane). Does not count GRacer, used for cab slowing and speeding up and cabs don't avoid GRacer.
-    bool projectileMaybeDamageActor(const Actor* projectile) const;
+    template <class A>
+    bool overlapWithRacer(const A& a) const{                                                    //allows actors (or rows) to determine whether they overlap with the racer
+        return theyOverlap(a, *m_racer);
+    }
+    void closestCAWActorsInLane(const double& x, const double& y, double& pixelsFront, double& pixelsBack) const;     //finds the closest live CAW actors in front or behind the point (in its lane). Does not count GRacer, used for cab slowing and speeding up and cabs don't avoid GRacer.
+    bool projectileMaybeDamageActor(const Actor& projectile) const;
+    bool projectileMaybeDamageActor(const ActorRow& projectile);                                //same for a projectile row
+    void caWorthyActorMoved(Actor* a, const double& oldX, const double& oldY);      //keeps the lane index up to date, called by CAW actors whenever they move
     
 private:
+    ActorArena                  m_arena;                                    //storage for every actor in the level, including GRacer
+    StorageMode                 m_storageMode;                              //objects or rows for the actors below
     std::vector< Actor* >       m_actors;                                   //container for all actors
+    LaneIndex                   m_laneIndex;                                //every live CAW actor in m_actors (so never GRacer) by lane and y, used by the cab lane queries
+    ActorColumns                m_columns;                                  //all actors other than GRacer (column storage), one row each in update order. queried by scanning, which is what the columns are for
     GhostRacer*                 m_racer;                                    //separate pointer to GhostRacer
     int                         m_souls2Save;                               //holds # of souls left to save on current level
     int                         m_bonusPoints;                              //holds # of bonus points awarded if win level rn
     double                      m_highestWhiteBorder;                       //holds y coord of highest white border line
-    std::ostringstream          gameStats;                                  //stringstream which is edited and set as game text each tick
     
     //private helpers:
-    bool theyOverlap(const Actor* a, const Actor* b) const;                             //finds whether two actors overlap
+    template <class A, class B>
+    bool theyOverlap(const A& a, const B& b) const{                                     //finds whether two actors overlap
+        double delta_x = std::abs( a.getX() - b.getX() );
+        double delta_y = std::abs( a.getY() - b.getY() );
+        int radius_sum = a.getRadius() + b.getRadius();
+        if (delta_x < radius_sum* 0.25 && delta_y < radius_sum * 0.6)       //if condition is met, two actors are said to overlap
+            return true;
+        return false;                                                       //otherwise return false
+    }
+    void destroyActor(Actor* a);                                                        //destroys a dead actor and gives its slot back to the arena
     bool findSafePlaceForCab(int& chosenLane, double& startY, double& startSpeed);         //tries to find a safe place to spawn a Zombie Cab
     int getActorLane(const Actor* a) const;                                             //returns lane an Actor is in
+    int getLane(const double& x) const;                                                 //returns lane an x coordinate is in
+    int laneBucket(const double& x) const;                                              //lane index bucket for an x coordinate
+    virtual void saveWorld(StateWriter& out) const;                                     //this world's part of a save state: level counters, GRacer and every live actor in update order
+    virtual bool restoreWorld(StateReader& in);                                         //rebuilds the level a save state describes
+    Actor* makeActorFromState(const ActorState& state);                                 //builds (but doesn't add) an actor of state's kind, null if it isn't one the level can hold
+    void addRow(const Actor& made);                                                     //column storage: appends a row that starts out as made is
+    bool moveRows();                                                                    //column storage: gives every live row its turn, in order. false as soon as GRacer dies
+    bool rowIsCAWInLane(const std::size_t& row, const int& bucket) const;               //column storage: live CAW row in the given lane index bucket
     double lowestCAWActorInLane(const int& laneNumber);                                    //returns the y coordinate of the lowest CAW Actor in any given lane. used for cab spawning and includes GRacer
     double highestCAWActorInLane(const int& laneNumber);                                   //returns y coord of highest CAW Actor in any given lane. Used for cab spawning and includes GRacer
     void addBorderLines();
@@ -72,7 +132,6 @@ private:
     void addHumanPeds();
     void addHolyWaterGoodies();
     void addSoulGoodies();
-    
 };
 
 #endif // STUDENTWORLD_H_
@@ -0,0 +1,135 @@
+#ifndef TRIGTABLE_H_
+#define TRIGTABLE_H_
+
+#include <array>
+
+  // Sine and cosine of whole-degree angles, for moving things in the
+  // simulation.  The tables are built by the compiler in double-double
+  // arithmetic (only +, -, * and / on doubles, which every IEEE machine
+  // does the same way) and rounded once to double, so each entry is the
+  // nearest double to the true value and the same in every build.  The
+  // library sin/cos of the old radian formulas differ from these by a few
+  // units in the last place at most (and cos(90) is now exactly 0 rather
+  // than 6e-17), far below anything the game compares against.
+
+class TrigTable
+{
+  public:
+	static double sinDegrees(int degrees)
+	{
+		return table().sine[normalize(degrees)];
+	}
+
+	static double cosDegrees(int degrees)
+	{
+		return table().sine[normalize(degrees + 90)];
+	}
+
+  private:
+	static const int DEGREES = 360;
+
+	struct Tables
+	{
+		std::array<double, DEGREES> sine;
+	};
+
+	struct DoubleDouble
+	{
+		double hi;
+		double lo;
+	};
+
+	static constexpr int normalize(int degrees)
+	{
+		degrees %= DEGREES;
+		return degrees < 0 ? degrees + DEGREES : degrees;
+	}
+
+	static constexpr DoubleDouble twoSum(double a, double b)
+	{
+		double s = a + b;
+		double bb = s - a;
+		return { s, (a - (s - bb)) + (b - bb) };
+	}
+
+	static constexpr DoubleDouble twoProduct(double a, double b)
+	{
+		  // Dekker's product: split each factor into 26-bit halves so the
+		  // partial products are exact
+		double ta = 134217729.0 * a;
+		double aHi = ta - (ta - a);
+		double aLo = a - aHi;
+		double tb = 134217729.0 * b;
+		double bHi = tb - (tb - b);
+		double bLo = b - bHi;
+		double p = a * b;
+		return { p, ((aHi * bHi - p) + aHi * bLo + aLo * bHi) + aLo * bLo };
+	}
+
+	static constexpr DoubleDouble add(DoubleDouble a, DoubleDouble b)
+	{
+		DoubleDouble s = twoSum(a.hi, b.hi);
+		return twoSum(s.hi, s.lo + a.lo + b.lo);
+	}
+
+	static constexpr DoubleDouble multiply(DoubleDouble a, DoubleDouble b)
+	{
+		DoubleDouble p = twoProduct(a.hi, b.hi);
+		return twoSum(p.hi, p.lo + a.hi * b.lo + a.lo * b.hi);
+	}
+
+	static constexpr DoubleDouble divide(DoubleDouble a, double b)
+	{
+		double q = a.hi / b;
+		DoubleDouble p = twoProduct(q, b);
+		return twoSum(q, ((a.hi - p.hi) - p.lo + a.lo) / b);
+	}
+
+	  // sin (or cos, starting from term 1) of x by its Taylor series; x is
+	  // at most pi/4, so 30 terms are far past double-double precision
+	static constexpr double series(DoubleDouble x, bool cosine)
+	{
+		DoubleDouble x2 = multiply(x, x);
+		DoubleDouble term = cosine ? DoubleDouble{ 1, 0 } : x;
+		DoubleDouble sum = term;
+		for (int n = cosine ? 0 : 1; n < 60; n += 2)
+		{
+			term = divide(multiply(term, x2), -static_cast<double>((n + 1) * (n + 2)));
+			sum = add(sum, term);
+		}
+		return sum.hi + sum.lo;
+	}
+
+	  // sin of a degree angle in 0-90, reduced to at most 45 degrees
+	static constexpr double firstQuadrant(int degrees)
+	{
+		constexpr DoubleDouble PI = { 3.141592653589793116, 1.2246467991473532e-16 };
+		bool cosine = degrees > 45;
+		DoubleDouble x = divide(multiply(PI, { static_cast<double>(cosine ? 90 - degrees : degrees), 0 }), 180);
+		return series(x, cosine);
+	}
+
+	static constexpr Tables build()
+	{
+		Tables t{};
+		for (int d = 0; d < DEGREES; d++)
+		{
+			int q = d / 90;
+			int r = d % 90;
+			double v = (q % 2 == 0) ? firstQuadrant(r) : firstQuadrant(90 - r);
+			t.sine[d] = (q < 2  ||  v == 0) ? v : -v;
+		}
+		return t;
+	}
+
+	static const Tables& table()
+	{
+		static constexpr Tables TABLES = build();
+		static_assert(TABLES.sine[30] == 0.5  &&  TABLES.sine[90] == 1  &&  TABLES.sine[150] == 0.5
+					  &&  TABLES.sine[180] == 0  &&  TABLES.sine[270] == -1, "exact angles come out exact");
+		static_assert(normalize(-90) == 270  &&  normalize(720) == 0, "angles wrap to 0-359");
+		return TABLES;
+	}
+};
+
+#endif // TRIGTABLE_H_
@@ -0,0 +1,64 @@
+#ifndef TRIPLEBUFFER_H_
+#define TRIPLEBUFFER_H_
+
+#include <atomic>
+
+  // Hands the newest of a stream of values from one thread to another
+  // without either ever waiting.  The writer fills back() and publish()es
+  // it; the reader calls update() and then reads front(), which stays put
+  // until its next update().  With three slots there is always one the
+  // writer can fill while the reader holds another and the third waits in
+  // the middle, so values the reader was too slow to see are simply
+  // replaced by newer ones.  The slots are reused, so T can keep its
+  // allocations (vectors, strings) from one publish to the next.
+
+template <typename T>
+class TripleBuffer
+{
+  public:
+	TripleBuffer()
+	 : m_back(0), m_middle(1), m_front(2)
+	{
+	}
+
+	  // Writer side.
+	T& back()
+	{
+		return m_slots[m_back];
+	}
+
+	void publish()
+	{
+		m_back = m_middle.exchange(m_back | FRESH, std::memory_order_acq_rel) & INDEX;
+	}
+
+	  // Reader side: move to the newest published value, if there is one
+	  // the reader hasn't seen; returns whether front() changed.
+	bool update()
+	{
+		if ((m_middle.load(std::memory_order_relaxed) & FRESH) == 0)
+			return false;
+		m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & INDEX;
+		return true;
+	}
+
+	const T& front() const
+	{
+		return m_slots[m_front];
+	}
+
+  private:
+	static const int INDEX = 3;		// the slot number in m_middle
+	static const int FRESH = 4;		// set when m_middle holds a value the reader hasn't taken
+
+	T					m_slots[3];
+	int					m_back;		// the writer's alone
+	std::atomic<int>	m_middle;
+	int					m_front;	// the reader's alone
+
+	  // Prevent copying or assigning buffers
+	TripleBuffer(const TripleBuffer&);
+	TripleBuffer& operator=(const TripleBuffer&);
+};
+
+#endif // TRIPLEBUFFER_H_
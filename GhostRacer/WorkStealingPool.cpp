@@ -0,0 +1,134 @@
+#include "WorkStealingPool.h"
+#include <utility>
+using namespace std;
+
+WorkStealingPool::WorkStealingPool(unsigned int numThreads)
+ : m_nextQueue(0), m_queued(0), m_unfinished(0), m_sleepers(0), m_stopping(false)
+{
+	if (numThreads == 0)
+		numThreads = thread::hardware_concurrency();
+	if (numThreads == 0)
+		numThreads = 1;
+
+	for (unsigned int k = 0; k < numThreads; k++)
+		m_queues.emplace_back(new WorkerQueue);
+	for (unsigned int k = 0; k < numThreads; k++)
+		m_threads.emplace_back(&WorkStealingPool::workerLoop, this, k);
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+	wait();
+	{
+		lock_guard<mutex> lock(m_stateMutex);
+		m_stopping = true;
+	}
+	m_workAvailable.notify_all();
+	for (size_t k = 0; k < m_threads.size(); k++)
+		m_threads[k].join();
+}
+
+void WorkStealingPool::submit(function<void()> task)
+{
+	unsigned int index = m_nextQueue++ % m_queues.size();
+	m_unfinished++;
+	{
+		lock_guard<mutex> lock(m_queues[index]->m_mutex);
+		m_queues[index]->m_tasks.push_back(std::move(task));
+	}
+	  // counted only once it can actually be taken, so a worker that
+	  // claims one is guaranteed to find something
+	m_queued++;
+
+	  // A worker goes to sleep by counting itself in m_sleepers and only
+	  // then checking m_queued, and we count the task before checking
+	  // m_sleepers, so either it sees the task or we see it and wake it.
+	  // Taking the lock, even for nothing, keeps the wakeup from landing
+	  // between its check and its wait.
+	if (m_sleepers > 0)
+	{
+		{
+			lock_guard<mutex> lock(m_stateMutex);
+		}
+		m_workAvailable.notify_one();
+	}
+}
+
+void WorkStealingPool::wait()
+{
+	unique_lock<mutex> lock(m_stateMutex);
+	m_allDone.wait(lock, [this] { return m_unfinished == 0; });
+}
+
+  // Takes one from m_queued if it isn't 0
+bool WorkStealingPool::claimTask()
+{
+	size_t queued = m_queued.load();
+	while (queued > 0)
+	{
+		if (m_queued.compare_exchange_weak(queued, queued - 1))
+			return true;
+	}
+	return false;
+}
+
+void WorkStealingPool::workerLoop(unsigned int index)
+{
+	for (;;)
+	{
+		if (!claimTask())
+		{
+			unique_lock<mutex> lock(m_stateMutex);
+			m_sleepers++;
+			m_workAvailable.wait(lock, [this] { return m_stopping  ||  m_queued > 0; });
+			m_sleepers--;
+			if (m_queued == 0)
+				return;		// stopping, and nothing left to run
+			continue;		// go and claim it; another worker may get there first
+		}
+
+		Task task;
+		while (!takeTask(index, task))
+			this_thread::yield();	// every claim is backed by a queued task; we only get here racing other workers for them
+
+		task();
+
+		if (--m_unfinished == 0)
+		{
+			lock_guard<mutex> lock(m_stateMutex);
+			m_allDone.notify_all();
+		}
+	}
+}
+
+bool WorkStealingPool::takeTask(unsigned int index, Task& task)
+{
+	return popOwn(index, task)  ||  steal(index, task);
+}
+
+bool WorkStealingPool::popOwn(unsigned int index, Task& task)
+{
+	WorkerQueue& q = *m_queues[index];
+	lock_guard<mutex> lock(q.m_mutex);
+	if (q.m_tasks.empty())
+		return false;
+	task = std::move(q.m_tasks.back());
+	q.m_tasks.pop_back();
+	return true;
+}
+
+bool WorkStealingPool::steal(unsigned int thief, Task& task)
+{
+	for (size_t k = 1; k < m_queues.size(); k++)
+	{
+		WorkerQueue& q = *m_queues[(thief + k) % m_queues.size()];
+		lock_guard<mutex> lock(q.m_mutex);
+		if (!q.m_tasks.empty())
+		{
+			task = std::move(q.m_tasks.front());
+			q.m_tasks.pop_front();
+			return true;
+		}
+	}
+	return false;
+}
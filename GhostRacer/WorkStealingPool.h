@@ -0,0 +1,75 @@
+#ifndef WORKSTEALINGPOOL_H_
+#define WORKSTEALINGPOOL_H_
+
+#include <functional>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstddef>
+
+  // A fixed set of worker threads, each with its own task deque.  A worker
+  // runs its own tasks newest first and, when it runs dry, steals the
+  // oldest task from another worker.  Tasks that take very different
+  // amounts of time (whole games, say) still keep every thread busy
+  // without one shared queue they all contend on.  The pool-wide counts of
+  // queued and unfinished tasks are atomics; the one shared mutex is only
+  // taken to sleep when there is no work, to wake a sleeper, and to wait
+  // for (or announce) the last task finishing.
+
+class WorkStealingPool
+{
+  public:
+	  // numThreads 0 means one per hardware thread
+	explicit WorkStealingPool(unsigned int numThreads = 0);
+
+	  // Finishes every task already submitted, then stops the workers.
+	~WorkStealingPool();
+
+	  // Queues task on the next worker in turn.  May be called from any
+	  // thread, including from inside a task.
+	void submit(std::function<void()> task);
+
+	  // Blocks until every task submitted so far has finished.
+	void wait();
+
+	unsigned int numThreads() const
+	{
+		return static_cast<unsigned int>(m_threads.size());
+	}
+
+  private:
+	using Task = std::function<void()>;
+
+	struct WorkerQueue
+	{
+		std::mutex			m_mutex;
+		std::deque<Task>	m_tasks;
+	};
+
+	std::vector<std::unique_ptr<WorkerQueue>>	m_queues;
+	std::vector<std::thread>					m_threads;
+	std::atomic<unsigned int>					m_nextQueue;	// round-robin target for submit()
+	std::mutex				m_stateMutex;	// only for sleeping on and signalling the conditions below
+	std::condition_variable	m_workAvailable;
+	std::condition_variable	m_allDone;
+	std::atomic<std::size_t>	m_queued;		// tasks sitting in some deque and not yet claimed
+	std::atomic<std::size_t>	m_unfinished;	// tasks submitted but not yet finished
+	std::atomic<unsigned int>	m_sleepers;		// workers waiting on m_workAvailable
+	bool					m_stopping;		// guarded by m_stateMutex
+
+	void workerLoop(unsigned int index);
+	bool claimTask();
+	bool takeTask(unsigned int index, Task& task);
+	bool popOwn(unsigned int index, Task& task);
+	bool steal(unsigned int thief, Task& task);
+
+	  // Prevent copying or assigning pools
+	WorkStealingPool(const WorkStealingPool&);
+	WorkStealingPool& operator=(const WorkStealingPool&);
+};
+
+#endif // WORKSTEALINGPOOL_H_
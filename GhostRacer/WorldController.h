@@ -0,0 +1,24 @@
+#ifndef WORLDCONTROLLER_H_
+#define WORLDCONTROLLER_H_
+
+#include <string>
+
+  // The services a GameWorld needs from whatever is driving it.  The GLUT
+  // GameController implements this for interactive play; the headless driver
+  // implements it without any windowing or sound so worlds can be stepped
+  // as fast as the CPU allows.
+
+class WorldController
+{
+  public:
+	virtual ~WorldController()
+	{
+	}
+
+	virtual bool getLastKey(int& value) = 0;
+	virtual void playSound(int soundID) = 0;
+	virtual void quitGame() = 0;
+	virtual void setMsPerTick(int ms_per_tick) = 0;
+};
+
+#endif // WORLDCONTROLLER_H_
@@ -0,0 +1,79 @@
+#include "WorldRunner.h"
+#include "HeadlessController.h"
+#include "Autopilot.h"
+#include "GameWorld.h"
+#include <chrono>
+using namespace std;
+
+WorldRunner::WorldRunner(WorldFactory makeWorld, unsigned int numThreads)
+ : m_makeWorld(makeWorld), m_pool(numThreads), m_seconds(0)
+{
+}
+
+vector<WorldRunner::EpisodeResult> WorldRunner::run(const vector<Episode>& episodes)
+{
+	m_results.assign(episodes.size(), EpisodeResult());
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+	for (size_t k = 0; k < episodes.size(); k++)
+	{
+		  // each task writes only its own slot, so no locking is needed
+		m_pool.submit([this, &episodes, k] { m_results[k] = playEpisode(episodes[k]); });
+	}
+	m_pool.wait();
+
+	chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+	m_seconds = elapsed.count();
+	return m_results;
+}
+
+WorldRunner::EpisodeResult WorldRunner::playEpisode(const Episode& episode) const
+{
+	GameWorld* gw = m_makeWorld();
+	gw->seedRandom(episode.seed);
+	HeadlessController controller(episode.keyScript);
+	Autopilot autopilot(m_makeWorld, episode.lookahead);
+	if (episode.lookahead > 0)
+		controller.setAutopilot(&autopilot);
+	HeadlessController::RunStats stats = controller.run(gw, episode.maxTicks);
+	delete gw;
+
+	EpisodeResult result;
+	result.seed = episode.seed;
+	result.ticks = stats.ticks;
+	result.score = stats.score;
+	result.level = stats.level;
+	result.lives = stats.lives;
+	result.gameOver = stats.gameOver;
+	return result;
+}
+
+WorldRunner::Summary WorldRunner::summary() const
+{
+	Summary s;
+	s.episodes = static_cast<int>(m_results.size());
+	s.gamesOver = 0;
+	s.totalTicks = 0;
+	s.bestScore = 0;
+	s.maxLevel = 0;
+	s.seconds = m_seconds;
+	double totalScore = 0;
+	double totalLevel = 0;
+	for (size_t k = 0; k < m_results.size(); k++)
+	{
+		const EpisodeResult& r = m_results[k];
+		if (r.gameOver)
+			s.gamesOver++;
+		s.totalTicks += r.ticks;
+		totalScore += r.score;
+		totalLevel += r.level;
+		if (k == 0  ||  r.score > s.bestScore)
+			s.bestScore = r.score;
+		if (r.level > s.maxLevel)
+			s.maxLevel = r.level;
+	}
+	s.meanTicks = s.episodes > 0 ? static_cast<double>(s.totalTicks) / s.episodes : 0;
+	s.meanScore = s.episodes > 0 ? totalScore / s.episodes : 0;
+	s.meanLevel = s.episodes > 0 ? totalLevel / s.episodes : 0;
+	return s;
+}
@@ -0,0 +1,83 @@
+#ifndef WORLDRUNNER_H_
+#define WORLDRUNNER_H_
+
+#include "WorkStealingPool.h"
+#include <string>
+#include <vector>
+#include <functional>
+
+class GameWorld;
+
+  // Plays many independent games at once on a WorkStealingPool.  Every
+  // episode gets a fresh world, its own seed and its own key script, and
+  // runs start to finish on one worker thread.  Worlds keep their display
+  // registry and random generator to themselves, so an episode's result
+  // depends only on its seed and script, never on how the episodes
+  // happened to be scheduled.
+
+class WorldRunner
+{
+  public:
+	struct Episode
+	{
+		unsigned int	seed;
+		std::string		keyScript;	// HeadlessController script
+		long			maxTicks;
+		int				lookahead;	// > 0: an Autopilot searching this many ticks ahead plays instead of the script
+	};
+
+	struct EpisodeResult
+	{
+		unsigned int	seed;
+		long			ticks;		// ticks survived
+		int				score;
+		int				level;		// level reached
+		int				lives;
+		bool			gameOver;
+	};
+
+	struct Summary
+	{
+		int		episodes;
+		int		gamesOver;
+		long	totalTicks;
+		double	meanTicks;
+		double	meanScore;
+		double	meanLevel;
+		int		bestScore;
+		int		maxLevel;
+		double	seconds;	// wall clock for the whole batch
+
+		double ticksPerSecond() const
+		{
+			return seconds > 0 ? totalTicks / seconds : 0;
+		}
+	};
+
+	using WorldFactory = std::function<GameWorld*()>;
+
+	  // makeWorld is called once per episode, on the thread that will play
+	  // it; the runner deletes the world when the episode ends.
+	WorldRunner(WorldFactory makeWorld, unsigned int numThreads = 0);
+
+	  // Plays every episode and returns their results in the same order.
+	std::vector<EpisodeResult> run(const std::vector<Episode>& episodes);
+
+	  // Aggregate of the results from the last run().
+	Summary summary() const;
+
+	unsigned int numThreads() const
+	{
+		return m_pool.numThreads();
+	}
+
+  private:
+	WorldFactory				m_makeWorld;
+	WorkStealingPool			m_pool;
+	std::vector<EpisodeResult>	m_results;
+	double						m_seconds;
+
+	EpisodeResult playEpisode(const Episode& episode) const;
+};
+
+#endif // WORLDRUNNER_H_
@@ -0,0 +1,51 @@
+// Entry point for the GhostRacerBundle target: packs the sprites (atlas and
+// mipmaps made) and sounds in an Assets directory into an asset bundle,
+// which the game loads in their place when it finds it in its Assets
+// directory as AssetBundle::FILE_NAME.
+//
+// usage: GhostRacerBundle ASSETDIR OUT
+
+#include "AssetBundle.h"
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <chrono>
+using namespace std;
+
+static void usage(const char* prog)
+{
+	cout << "usage: " << prog << " ASSETDIR OUT" << endl
+		 << "  Packs the sprites and sounds in ASSETDIR into the asset bundle OUT," << endl
+		 << "  which the game loads in their place when it finds it in its Assets" << endl
+		 << "  directory as " << AssetBundle::FILE_NAME << "." << endl;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc != 3)
+	{
+		usage(argv[0]);
+		return 1;
+	}
+	string assetDir = argv[1];
+	string outPath = argv[2];
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	if (!assetDir.empty()  &&  assetDir[assetDir.size()-1] != '/')
+		assetDir += '/';
+	if (!AssetBundle::write(outPath, assetDir))
+		return 1;
+
+	AssetBundle bundle;
+	if (!bundle.open(outPath))
+	{
+		cout << "Cannot read back asset bundle " << outPath << endl;
+		return 1;
+	}
+	ifstream written(outPath, ios::binary | ios::ate);
+	cout << "wrote " << outPath << ": " << written.tellg() << " bytes, "
+		 << bundle.atlasWidth() << "x" << bundle.atlasHeight() << " atlas, "
+		 << bundle.numLevels() << " mipmap levels, " << bundle.numFrames() << " frames, "
+		 << chrono::duration<double>(chrono::steady_clock::now() - start).count() << " seconds" << endl;
+	return 0;
+}
@@ -0,0 +1,430 @@
+// Entry point for the GhostRacerHeadless target: runs StudentWorld with no
+// window, timer or sound and reports how many ticks per second it managed.
+//
+// usage: GhostRacerHeadless [--games N] [--ticks N] [--keys SCRIPT] [--keys-file PATH]
+//                           [--scripts-file PATH] [--seed S] [--threads N]
+//                           [--record PATH] [--replay PATH]
+//                           [--pack LOG OUT] [--keyframes N] [--seek REPLAY TICK] [--verify]
+//                           [--checkpoint PATH] [--checkpoint-every N] [--resume PATH]
+//                           [--autopilot] [--lookahead N] [--columns]
+
+#include "HeadlessController.h"
+#include "WorldRunner.h"
+#include "InputLog.h"
+#include "ReplayFile.h"
+#include "Checkpoint.h"
+#include "Autopilot.h"
+#include "StateStream.h"
+#include "StudentWorld.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <random>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <chrono>
+using namespace std;
+
+static void usage(const char* prog)
+{
+	cout << "usage: " << prog << " [--games N] [--ticks N] [--keys SCRIPT] [--keys-file PATH]" << endl
+		 << "       [--scripts-file PATH] [--seed S] [--threads N]" << endl
+		 << "       [--record PATH] [--replay PATH]" << endl
+		 << "       [--pack LOG OUT] [--keyframes N] [--seek REPLAY TICK] [--verify]" << endl
+		 << "       [--checkpoint PATH] [--checkpoint-every N] [--resume PATH]" << endl
+		 << "       [--autopilot] [--lookahead N] [--columns]" << endl
+		 << "  Plays N games (default 1) of at most --ticks ticks each." << endl
+		 << "  SCRIPT has one character per tick: a/d/w/s steer and throttle," << endl
+		 << "  space fires, '.' is no key, q quits.  It repeats when exhausted." << endl
+		 << "  --scripts-file gives one script per line; game i plays line i" << endl
+		 << "  (wrapping around).  --seed S seeds game i with S+i, so runs repeat." << endl
+		 << "  --threads N plays the games in parallel on N threads (0 = all cores)." << endl
+		 << "  --record saves each game's seed and keys to PATH (PATH.N for game N" << endl
+		 << "  when playing several); --replay plays such a log back and reports" << endl
+		 << "  whether it ends the same way." << endl
+		 << "  --pack turns a log into a seekable replay with a keyframe every N" << endl
+		 << "  ticks (default 1000); --seek jumps into one at TICK and prints the" << endl
+		 << "  world there (--verify also plays it from tick 0 and compares)." << endl
+		 << "  --checkpoint saves each game's world to PATH (PATH.N as for --record)" << endl
+		 << "  every N ticks (default 1000); --resume carries on from such a file," << endl
+		 << "  with the same keys, until the game has made --ticks ticks in all." << endl
+		 << "  --autopilot plays by searching N ticks ahead (default " << Autopilot::DEFAULT_LOOKAHEAD << ")" << endl
+		 << "  on copies of the world instead of following a script." << endl
+		 << "  --columns keeps the actors in column storage instead of one object" << endl
+		 << "  each; games play out exactly the same either way." << endl;
+}
+
+static double secondsSince(chrono::steady_clock::time_point start)
+{
+	chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+	return elapsed.count();
+}
+
+  // FNV-1a of the world's save state: equal worlds print equal fingerprints
+static uint64_t stateFingerprint(const GameWorld* gw)
+{
+	StateWriter state;
+	gw->saveState(state);
+	return stateChecksum(state.data(), state.size());
+}
+
+static bool readFile(const char* path, string& contents)
+{
+	ifstream ifs(path);
+	if (!ifs)
+	{
+		cout << "Cannot open key script " << path << endl;
+		return false;
+	}
+	ostringstream oss;
+	oss << ifs.rdbuf();
+	contents = oss.str();
+	return true;
+}
+
+  // Plays log back as fast as possible and compares the result with the
+  // recorded one.  Returns the process exit status.
+static int replay(const InputLog& log, const WorldRunner::WorldFactory& makeWorld, long maxTicks)
+{
+	if (log.finished())
+		maxTicks = log.outcome().ticks;
+
+	GameWorld* gw = makeWorld();
+	gw->seedRandom(log.seed());
+	InputLog replayed;
+	gw->startRecording(&replayed);
+	HeadlessController controller(log);
+	HeadlessController::RunStats stats = controller.run(gw, maxTicks);
+	gw->stopRecording();
+	delete gw;
+
+	cout << "replay: ticks: " << stats.ticks
+		 << "  score: " << stats.score
+		 << "  level: " << stats.level
+		 << "  lives: " << stats.lives
+		 << (stats.gameOver ? "  (game over)" : "") << endl;
+	cout << "seconds: " << stats.seconds
+		 << "  ticks/sec: " << static_cast<long>(stats.ticksPerSecond()) << endl;
+
+	string diverged = log.divergence(replayed);
+	if (!diverged.empty())
+	{
+		cout << "DIVERGED: " << diverged << endl;
+		return 1;
+	}
+	cout << "replay matches the recording" << endl;
+	return 0;
+}
+
+static int pack(const InputLog& log, const WorldRunner::WorldFactory& makeWorld, string outPath, long keyframeInterval)
+{
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	GameWorld* gw = makeWorld();
+	bool written = ReplayFile::write(outPath, log, gw, keyframeInterval);
+	delete gw;
+	ReplayFile replay;
+	if (!written  ||  !replay.open(outPath))
+	{
+		cout << "Cannot write replay " << outPath << endl;
+		return 1;
+	}
+	cout << "wrote " << outPath << ": " << replay.ticks() << " ticks, "
+		 << replay.numKeyframes() << " keyframes, " << secondsSince(start) << " seconds" << endl;
+
+	string diverged = log.divergence(replay.inputLog());
+	if (!diverged.empty())
+	{
+		cout << "DIVERGED: " << diverged << endl;
+		return 1;
+	}
+	return 0;
+}
+
+static int seek(string path, long tick, const WorldRunner::WorldFactory& makeWorld, bool verify)
+{
+	ReplayFile replay;
+	if (!replay.open(path))
+	{
+		cout << "Cannot read replay " << path << endl;
+		return 1;
+	}
+
+	GameWorld* gw = makeWorld();
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	if (!replay.seek(gw, tick))
+	{
+		cout << "Cannot seek to tick " << tick << " (the replay has " << replay.ticks() << ")" << endl;
+		delete gw;
+		return 1;
+	}
+	double seconds = secondsSince(start);
+	uint64_t fingerprint = stateFingerprint(gw);
+	cout << "tick " << tick << ": score: " << gw->getScore()
+		 << "  level: " << gw->getLevel()
+		 << "  lives: " << gw->getLives() << endl;
+	cout << "keyframe at tick " << replay.lastKeyframeTick() << " + "
+		 << tick - replay.lastKeyframeTick() << " ticks simulated, "
+		 << seconds << " seconds  state: " << hex << fingerprint << dec << endl;
+	delete gw;
+
+	if (!verify)
+		return 0;
+
+	GameWorld* full = makeWorld();
+	full->seedRandom(replay.seed());
+	InputLog log = replay.inputLog();
+	HeadlessController controller(log);
+	start = chrono::steady_clock::now();
+	controller.run(full, tick);
+	seconds = secondsSince(start);
+	bool same = (stateFingerprint(full) == fingerprint);
+	delete full;
+	cout << "replay from tick 0: " << seconds << " seconds, "
+		 << (same ? "same state" : "DIFFERENT STATE") << endl;
+	return same ? 0 : 1;
+}
+
+int main(int argc, char* argv[])
+{
+	int numGames = 1;
+	long maxTicks = 100000;
+	string keyScript;
+	vector<string> scripts;
+	bool seeded = false;
+	unsigned int seed = 0;
+	int numThreads = -1;		// -1: play the games one after another on this thread
+	string recordPath;
+	string replayPath;
+	string packOutPath;
+	long keyframeInterval = 1000;
+	string seekPath;
+	long seekTick = 0;
+	bool verify = false;
+	string checkpointPath;
+	long checkpointInterval = 1000;
+	string resumePath;
+	int lookahead = 0;		// 0: no autopilot
+	bool columns = false;
+
+	for (int k = 1; k < argc; k++)
+	{
+		if (strcmp(argv[k], "--games") == 0  &&  k+1 < argc)
+			numGames = atoi(argv[++k]);
+		else if (strcmp(argv[k], "--ticks") == 0  &&  k+1 < argc)
+			maxTicks = atol(argv[++k]);
+		else if (strcmp(argv[k], "--keys") == 0  &&  k+1 < argc)
+			keyScript = argv[++k];
+		else if (strcmp(argv[k], "--keys-file") == 0  &&  k+1 < argc)
+		{
+			if (!readFile(argv[++k], keyScript))
+				return 1;
+			  // newlines are only there to make script files readable
+			string::size_type pos;
+			while ((pos = keyScript.find_first_of("\r\n")) != string::npos)
+				keyScript.erase(pos, 1);
+		}
+		else if (strcmp(argv[k], "--scripts-file") == 0  &&  k+1 < argc)
+		{
+			string contents;
+			if (!readFile(argv[++k], contents))
+				return 1;
+			istringstream iss(contents);
+			string line;
+			while (getline(iss, line))
+			{
+				if (!line.empty()  &&  line[line.size()-1] == '\r')
+					line.erase(line.size()-1);
+				scripts.push_back(line);
+			}
+		}
+		else if (strcmp(argv[k], "--seed") == 0  &&  k+1 < argc)
+		{
+			seed = static_cast<unsigned int>(strtoul(argv[++k], nullptr, 10));
+			seeded = true;
+		}
+		else if (strcmp(argv[k], "--threads") == 0  &&  k+1 < argc)
+			numThreads = atoi(argv[++k]);
+		else if (strcmp(argv[k], "--record") == 0  &&  k+1 < argc)
+			recordPath = argv[++k];
+		else if (strcmp(argv[k], "--replay") == 0  &&  k+1 < argc)
+			replayPath = argv[++k];
+		else if (strcmp(argv[k], "--pack") == 0  &&  k+2 < argc)
+		{
+			replayPath = argv[++k];
+			packOutPath = argv[++k];
+		}
+		else if (strcmp(argv[k], "--keyframes") == 0  &&  k+1 < argc)
+			keyframeInterval = atol(argv[++k]);
+		else if (strcmp(argv[k], "--seek") == 0  &&  k+2 < argc)
+		{
+			seekPath = argv[++k];
+			seekTick = atol(argv[++k]);
+		}
+		else if (strcmp(argv[k], "--verify") == 0)
+			verify = true;
+		else if (strcmp(argv[k], "--checkpoint") == 0  &&  k+1 < argc)
+			checkpointPath = argv[++k];
+		else if (strcmp(argv[k], "--checkpoint-every") == 0  &&  k+1 < argc)
+			checkpointInterval = atol(argv[++k]);
+		else if (strcmp(argv[k], "--resume") == 0  &&  k+1 < argc)
+			resumePath = argv[++k];
+		else if (strcmp(argv[k], "--autopilot") == 0)
+		{
+			if (lookahead == 0)
+				lookahead = Autopilot::DEFAULT_LOOKAHEAD;
+		}
+		else if (strcmp(argv[k], "--lookahead") == 0  &&  k+1 < argc)
+			lookahead = atoi(argv[++k]);
+		else if (strcmp(argv[k], "--columns") == 0)
+			columns = true;
+		else
+		{
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (scripts.empty())
+		scripts.push_back(keyScript);
+	if (!seeded  &&  numThreads >= 0)
+		seed = random_device()();		// parallel games always get their own seeds
+
+	WorldRunner::WorldFactory makeWorld = [columns]() -> GameWorld* {
+		StudentWorld* world = new StudentWorld("");
+		if (columns)
+			world->setStorageMode(StudentWorld::COLUMN_STORAGE);
+		return world;
+	};
+
+	if (!seekPath.empty())
+		return seek(seekPath, seekTick, makeWorld, verify);
+
+	if (!replayPath.empty())
+	{
+		InputLog log;
+		if (!log.load(replayPath))
+		{
+			cout << "Cannot read input log " << replayPath << endl;
+			return 1;
+		}
+		if (!packOutPath.empty())
+			return pack(log, makeWorld, packOutPath, keyframeInterval);
+		return replay(log, makeWorld, maxTicks);
+	}
+
+	if (numThreads >= 0  &&  (!recordPath.empty()  ||  !checkpointPath.empty()  ||  !resumePath.empty()))
+	{
+		cout << "--record, --checkpoint and --resume play the games one at a time; drop --threads" << endl;
+		return 1;
+	}
+	if (!resumePath.empty()  &&  (numGames != 1  ||  !recordPath.empty()))
+	{
+		cout << "--resume carries on one game and can't record it; drop --games and --record" << endl;
+		return 1;
+	}
+	if (checkpointInterval < 1)
+		checkpointInterval = 1;
+
+	if (numThreads >= 0)
+	{
+		vector<WorldRunner::Episode> episodes(numGames);
+		for (int game = 0; game < numGames; game++)
+		{
+			episodes[game].seed = seed + game;
+			episodes[game].keyScript = scripts[game % scripts.size()];
+			episodes[game].maxTicks = maxTicks;
+			episodes[game].lookahead = lookahead;
+		}
+
+		WorldRunner runner(makeWorld, numThreads);
+		vector<WorldRunner::EpisodeResult> results = runner.run(episodes);
+		for (size_t game = 0; game < results.size(); game++)
+		{
+			const WorldRunner::EpisodeResult& r = results[game];
+			cout << "game " << game+1 << ": seed: " << r.seed
+				 << "  ticks: " << r.ticks
+				 << "  score: " << r.score
+				 << "  level: " << r.level
+				 << "  lives: " << r.lives
+				 << (r.gameOver ? "  (game over)" : "") << endl;
+		}
+
+		WorldRunner::Summary s = runner.summary();
+		cout << "games: " << s.episodes
+			 << "  mean score: " << s.meanScore
+			 << "  best score: " << s.bestScore
+			 << "  mean level: " << s.meanLevel
+			 << "  max level: " << s.maxLevel
+			 << "  mean ticks: " << s.meanTicks << endl;
+		cout << "total ticks: " << s.totalTicks
+			 << "  seconds: " << s.seconds
+			 << "  threads: " << runner.numThreads()
+			 << "  ticks/sec: " << static_cast<long>(s.ticksPerSecond()) << endl;
+		return 0;
+	}
+
+	long totalTicks = 0;
+	double totalSeconds = 0;
+	for (int game = 0; game < numGames; game++)
+	{
+		GameWorld* gw = makeWorld();
+		bool needInit = true;
+		if (!resumePath.empty())
+		{
+			if (!Checkpoint::load(resumePath, gw, needInit))
+			{
+				cout << "Cannot resume from checkpoint " << resumePath << endl;
+				delete gw;
+				return 1;
+			}
+			cout << "resuming at tick " << gw->getTick() << endl;
+		}
+		else if (seeded)
+			gw->seedRandom(seed + game);
+		InputLog log;
+		if (!recordPath.empty())
+			gw->startRecording(&log);
+		HeadlessController controller(scripts[game % scripts.size()]);
+		Autopilot autopilot(makeWorld, lookahead);
+		if (lookahead > 0)
+			controller.setAutopilot(&autopilot);
+		Checkpoint checkpoint;
+		if (!checkpointPath.empty())
+		{
+			string path = (numGames == 1 ? checkpointPath : checkpointPath + "." + to_string(game+1));
+			controller.setTickCallback([&checkpoint, path, checkpointInterval](GameWorld& w, bool needInit) {
+				if (w.getTick() % checkpointInterval == 0  &&  !checkpoint.save(path, w, needInit))
+					cout << "Cannot write checkpoint " << path << endl;
+			});
+		}
+		HeadlessController::RunStats stats = (resumePath.empty() ? controller.run(gw, maxTicks)
+																 : controller.resume(gw, maxTicks, needInit));
+		if (!recordPath.empty())
+		{
+			gw->stopRecording();
+			string path = (numGames == 1 ? recordPath : recordPath + "." + to_string(game+1));
+			if (!log.save(path))
+				cout << "Cannot write input log " << path << endl;
+		}
+		delete gw;
+
+		totalTicks += stats.ticks;
+		totalSeconds += stats.seconds;
+		cout << "game " << game+1 << ": ticks: " << stats.ticks
+			 << "  score: " << stats.score
+			 << "  level: " << stats.level
+			 << "  lives: " << stats.lives
+			 << (stats.gameOver ? "  (game over)" : "") << endl;
+		if (lookahead > 0  &&  stats.ticks > 0)
+			cout << "autopilot: " << autopilot.clonesMade() / stats.ticks << " copies and "
+				 << autopilot.ticksSimulated() / stats.ticks << " ticks simulated per tick, "
+				 << stats.seconds / stats.ticks * 1000 << " ms per tick" << endl;
+	}
+
+	cout << "total ticks: " << totalTicks
+		 << "  seconds: " << totalSeconds
+		 << "  ticks/sec: " << static_cast<long>(totalSeconds > 0 ? totalTicks / totalSeconds : 0) << endl;
+}
@@ -1,10 +1,13 @@
 // This file written by Professors Carey Nachenberg and David Smallberg for CS32 Student use in Project 3.  
 
 #include "GameController.h"
+#include "Autopilot.h"
+#include "AssetBundle.h"
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
 using namespace std;
 
@@ -47,9 +50,11 @@ int main(int argc, char* argv[])
         assetPath += '/';
     }
     {
+		  // either the asset bundle or the loose files will do
 		const string someAsset = "health.tga";
 		ifstream ifs(assetPath + someAsset);
-		if (!ifs)
+		ifstream bundle(assetPath + AssetBundle::FILE_NAME);
+		if (!ifs  &&  !bundle)
 		{
 			cout << "Cannot find " << someAsset << " in ";
 			cout << (assetDirectory.empty() ? "current directory" : assetDirectory) << endl;
@@ -59,6 +64,42 @@ int main(int argc, char* argv[])
 
 	srand(static_cast<unsigned int>(time(nullptr)));
 
+	  // --record PATH saves this game's seed and keys for GhostRacerHeadless --replay;
+	  // --autopilot lets an Autopilot drive instead of the keyboard;
+	  // --max-frame-skip N caps how many frames in a row may go undrawn under load
+	bool autopilotOn = false;
+	for (int k = 1; k < argc; )
+	{
+		int used = 0;
+		if (strcmp(argv[k], "--record") == 0  &&  k+1 < argc)
+		{
+			Game().setRecordPath(argv[k+1]);
+			used = 2;
+		}
+		else if (strcmp(argv[k], "--autopilot") == 0)
+		{
+			autopilotOn = true;
+			used = 1;
+		}
+		else if (strcmp(argv[k], "--max-frame-skip") == 0  &&  k+1 < argc)
+		{
+			Game().setMaxFrameSkip(atoi(argv[k+1]));
+			used = 2;
+		}
+		if (used == 0)
+		{
+			k++;
+			continue;
+		}
+		for (int j = k; j+used <= argc; j++)	// drop them from what glutInit sees
+			argv[j] = argv[j+used];
+		argc -= used;
+	}
+
+	Autopilot autopilot([assetPath]() { return createStudentWorld(assetPath); });
+	if (autopilotOn)
+		Game().setAutopilot(&autopilot);
+
 	GameWorld* gw = createStudentWorld(assetPath);
 	Game().run(argc, argv, gw, "Ghost Racer");
 }
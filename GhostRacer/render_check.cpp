@@ -0,0 +1,293 @@
+// Entry point for the GhostRacerRenderCheck target: plays StudentWorld
+// headless for a while, then draws that moment of the game the way the
+// game does, twice: each sprite on its own (SpriteManager::plotSprite) and
+// the whole frame batched (queueSprite/drawQueuedSprites).  It reads both
+// frames back and reports how far apart they are, so a change to either
+// drawing path can be checked against the other.  With --bundle it also
+// draws the batched frame from the asset bundle's atlas, which must match
+// the one packed from the TGA files exactly.
+//
+// usage: GhostRacerRenderCheck ASSETDIR [--ticks N] [--seed S] [--keys SCRIPT]
+//                              [--bundle PATH] [--out PPM]
+//
+// It draws into a GLUT window.  Built with RENDER_CHECK_EGL defined (and
+// linked with -lEGL instead of GLUT) it draws into an EGL pbuffer instead,
+// so it runs on a machine with no display, e.g. with Mesa's llvmpipe.
+
+#include "GameView.h"
+#include "GameAssets.h"
+#include "SpriteManager.h"
+#include "AssetBundle.h"
+#include "HeadlessController.h"
+#include "StudentWorld.h"
+#include "GraphObject.h"
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#ifdef RENDER_CHECK_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+using namespace std;
+
+  // How far the batched frame may stray from plotSprite's: queueSprite
+  // works out the corners on the CPU, in floats, so an edge texel can
+  // round the other way.
+static const int MAX_CHANNEL_DIFFERENCE = 2;
+
+struct Options
+{
+	string	assetDir;
+	long	ticks = 1500;
+	unsigned int seed = 11;
+	string	keys = " a d w  ww s";
+	string	bundlePath;
+	string	outPath = "render_check.ppm";
+};
+
+struct Comparison
+{
+	long	differingBytes = 0;
+	int		maxDifference = 0;
+};
+
+static Options s_options;
+static StudentWorld* s_world = nullptr;
+static int s_status = 1;
+
+static void usage(const char* prog)
+{
+	cout << "usage: " << prog << " ASSETDIR [--ticks N] [--seed S] [--keys SCRIPT]" << endl
+		 << "       [--bundle PATH] [--out PPM]" << endl
+		 << "  Plays --ticks ticks (default 1500) headless with the key script," << endl
+		 << "  then draws that frame sprite by sprite and batched and compares" << endl
+		 << "  them; they may differ by " << MAX_CHANNEL_DIFFERENCE << "/255 per channel at most." << endl
+		 << "  --bundle also draws the batched frame from the asset bundle PATH," << endl
+		 << "  which must match the one from the TGA files in ASSETDIR exactly." << endl
+		 << "  The batched frame is written to PPM (default render_check.ppm)." << endl;
+}
+
+static bool loadSprites(SpriteManager& sprites, string assetDir)
+{
+	for (size_t k = 0; k < NUM_GAME_SPRITES; k++)
+	{
+		if (!sprites.loadSprite(assetDir + GAME_SPRITES[k].tgaFileName, GAME_SPRITES[k].imageID, GAME_SPRITES[k].frameNum))
+		{
+			cout << "Cannot read sprite " << assetDir + GAME_SPRITES[k].tgaFileName << endl;
+			return false;
+		}
+	}
+	return sprites.buildAtlas();
+}
+
+  // Draws the world's visible GraphObjects as GameController::displayGamePlay
+  // does, deepest layer first, and reads the frame back as RGBA.
+static void drawFrame(SpriteManager& sprites, bool batched, vector<unsigned char>& pixels)
+{
+	beginGameFrame();
+	for (int depth = GraphObjectRegistry::NUM_DEPTHS - 1; depth >= 0; depth--)
+	{
+		const auto& objects = s_world->graphObjects().getGraphObjects(depth);
+		for (auto it = objects.begin(); it != objects.end(); it++)
+		{
+			GraphObject* cur = *it;
+			if (!cur->isVisible())
+				continue;
+
+			double x, y, gx, gy, gz;
+			cur->getAnimationLocation(x, y);
+			convertToGlutCoords(x, y, gx, gy, gz);
+			int imageID = cur->getID();
+			int frame = cur->getAnimationNumber() % sprites.getNumFrames(imageID);
+			if (batched)
+				sprites.queueSprite(imageID, frame, gx, gy, gz, cur->getDirection(), cur->getSize(), depth);
+			else
+				sprites.plotSprite(imageID, frame, gx, gy, gz, cur->getDirection(), cur->getSize());
+		}
+	}
+	if (batched)
+		sprites.drawQueuedSprites();
+	glFinish();
+
+	pixels.resize(static_cast<size_t>(WINDOW_WIDTH) * WINDOW_HEIGHT * 4);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+}
+
+static Comparison compare(const vector<unsigned char>& a, const vector<unsigned char>& b)
+{
+	Comparison result;
+	for (size_t k = 0; k < a.size(); k++)
+	{
+		int difference = abs(a[k] - b[k]);
+		if (difference != 0)
+		{
+			result.differingBytes++;
+			result.maxDifference = max(result.maxDifference, difference);
+		}
+	}
+	return result;
+}
+
+static bool writePpm(string path, const vector<unsigned char>& pixels)
+{
+	ofstream ofs(path, ios::binary);
+	ofs << "P6 " << WINDOW_WIDTH << " " << WINDOW_HEIGHT << " 255\n";
+	for (int row = WINDOW_HEIGHT - 1; row >= 0; row--)	// GL's rows run bottom up
+	{
+		for (int col = 0; col < WINDOW_WIDTH; col++)
+			ofs.write(reinterpret_cast<const char*>(&pixels[(static_cast<size_t>(row) * WINDOW_WIDTH + col) * 4]), 3);
+	}
+	return static_cast<bool>(ofs);
+}
+
+  // Does the whole check with a GL context current; returns the exit status.
+static int check()
+{
+	setUpGameProjection(WINDOW_WIDTH, WINDOW_HEIGHT);
+	glClearColor(0, 0, 0, 0);
+
+	SpriteManager sprites;
+	if (!loadSprites(sprites, s_options.assetDir))
+		return 1;
+
+	vector<unsigned char> immediate, batched;
+	drawFrame(sprites, false, immediate);
+	drawFrame(sprites, true, batched);
+	Comparison batching = compare(immediate, batched);
+	cout << "batched vs plotSprite: " << batching.differingBytes << " bytes differ (at most by "
+		 << batching.maxDifference << ")" << endl;
+	bool passed = batching.maxDifference <= MAX_CHANNEL_DIFFERENCE;
+
+	if (!s_options.bundlePath.empty())
+	{
+		AssetBundle bundle;
+		SpriteManager bundled;
+		if (!bundle.open(s_options.bundlePath)  ||  !bundled.loadAtlas(bundle))
+		{
+			cout << "Cannot load asset bundle " << s_options.bundlePath << endl;
+			return 1;
+		}
+		vector<unsigned char> fromBundle;
+		drawFrame(bundled, true, fromBundle);
+		Comparison bundling = compare(batched, fromBundle);
+		cout << "bundle vs TGA files: " << bundling.differingBytes << " bytes differ (at most by "
+			 << bundling.maxDifference << ")" << endl;
+		passed = passed  &&  bundling.differingBytes == 0;
+	}
+
+	if (GLenum error = glGetError())
+	{
+		cout << "GL error " << error << endl;
+		passed = false;
+	}
+	if (!writePpm(s_options.outPath, batched))
+		cout << "Cannot write " << s_options.outPath << endl;
+	cout << (passed ? "PASS" : "FAIL") << endl;
+	return passed ? 0 : 1;
+}
+
+#ifdef RENDER_CHECK_EGL
+
+static bool makeContext()
+{
+	PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+		reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+	EGLDisplay display = (getPlatformDisplay != nullptr
+						  ? getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr)
+						  : eglGetDisplay(EGL_DEFAULT_DISPLAY));
+	if (!eglInitialize(display, nullptr, nullptr))
+		return false;
+
+	const EGLint configAttributes[] = {
+		EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+		EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8,
+		EGL_DEPTH_SIZE, 16,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_NONE
+	};
+	EGLConfig config;
+	EGLint numConfigs = 0;
+	if (!eglChooseConfig(display, configAttributes, &config, 1, &numConfigs)  ||  numConfigs == 0)
+		return false;
+
+	const EGLint surfaceAttributes[] = { EGL_WIDTH, WINDOW_WIDTH, EGL_HEIGHT, WINDOW_HEIGHT, EGL_NONE };
+	EGLSurface surface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+	eglBindAPI(EGL_OPENGL_API);
+	EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, nullptr);
+	return surface != EGL_NO_SURFACE  &&  context != EGL_NO_CONTEXT
+		&&  eglMakeCurrent(display, surface, surface, context);
+}
+
+#else
+
+static void display()
+{
+	s_status = check();
+	delete s_world;
+	exit(s_status);
+}
+
+#endif
+
+int main(int argc, char* argv[])
+{
+	for (int i = 1; i < argc; i++)
+	{
+		string arg = argv[i];
+		if (arg == "--ticks"  &&  i+1 < argc)
+			s_options.ticks = atol(argv[++i]);
+		else if (arg == "--seed"  &&  i+1 < argc)
+			s_options.seed = static_cast<unsigned int>(strtoul(argv[++i], nullptr, 10));
+		else if (arg == "--keys"  &&  i+1 < argc)
+			s_options.keys = argv[++i];
+		else if (arg == "--bundle"  &&  i+1 < argc)
+			s_options.bundlePath = argv[++i];
+		else if (arg == "--out"  &&  i+1 < argc)
+			s_options.outPath = argv[++i];
+		else if (arg[0] != '-'  &&  s_options.assetDir.empty())
+			s_options.assetDir = arg;
+		else
+		{
+			usage(argv[0]);
+			return 1;
+		}
+	}
+	if (s_options.assetDir.empty())
+	{
+		usage(argv[0]);
+		return 1;
+	}
+	if (s_options.assetDir[s_options.assetDir.size()-1] != '/')
+		s_options.assetDir += '/';
+
+	s_world = new StudentWorld(s_options.assetDir);
+	s_world->seedRandom(s_options.seed);
+	HeadlessController controller(s_options.keys);
+	HeadlessController::RunStats stats = controller.run(s_world, s_options.ticks);
+	cout << "tick " << stats.ticks << ": score: " << stats.score
+		 << "  level: " << stats.level
+		 << "  lives: " << stats.lives << endl;
+
+#ifdef RENDER_CHECK_EGL
+	if (!makeContext())
+	{
+		cout << "Cannot make an EGL context" << endl;
+		delete s_world;
+		return 1;
+	}
+	s_status = check();
+	delete s_world;
+	return s_status;
+#else
+	glutInit(&argc, argv);
+	glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGBA | GLUT_DEPTH);
+	glutInitWindowSize(WINDOW_WIDTH, WINDOW_HEIGHT);
+	glutCreateWindow("GhostRacerRenderCheck");
+	glutDisplayFunc(display);
+	glutMainLoop();
+	return s_status;
+#endif
+}